@@ -1,7 +1,22 @@
 #include "src/app.h"
+#include "src/options.h"
+
+#include <iostream>
 
 auto main(int argc, char **argv) -> int
 {
-    auto app = Application();
+    ApplicationOptions options;
+
+    try
+    {
+        options = ParseOptions(argc, argv);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << '\n' << OptionsUsage();
+        return 1;
+    }
+
+    auto app = Application(options);
     app.Run();
 }
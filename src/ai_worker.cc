@@ -0,0 +1,103 @@
+#include "ai_worker.h"
+#include "counters.h"
+
+AiWorker::AiWorker(SearchOptions options) : options(std::move(options)), worker(&AiWorker::WorkerLoop, this)
+{
+}
+
+AiWorker::~AiWorker()
+{
+    stopping.store(true, std::memory_order_relaxed);
+    Wake();
+}
+
+void AiWorker::Wake()
+{
+    posted.fetch_add(1, std::memory_order_release);
+    posted.notify_one();
+}
+
+auto AiWorker::Post(const Board board) -> std::uint32_t
+{
+    // id 0 never names a request, so that Cancel can use it
+    const std::uint32_t id = ++next_id == 0 ? ++next_id : next_id;
+
+    wanted_id.store(id, std::memory_order_relaxed);
+
+    // a full queue only holds stale boards, the worker drains it to the newest one anyway
+    while (!requests.TryPush({board, id}))
+    {
+        std::this_thread::yield();
+    }
+
+    Wake();
+    return id;
+}
+
+void AiWorker::Cancel()
+{
+    wanted_id.store(0, std::memory_order_relaxed);
+}
+
+auto AiWorker::Result(const std::uint32_t id) const -> std::optional<Direction>
+{
+    const auto published = result.load(std::memory_order_acquire);
+
+    if (published == NO_RESULT || static_cast<std::uint32_t>(published >> 32) != id)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<Direction>((published & 0xffffffff) - 1);
+}
+
+auto AiWorker::SearchedNodes() const -> std::uint64_t
+{
+    return searched_nodes.load(std::memory_order_relaxed);
+}
+
+void AiWorker::WorkerLoop()
+{
+    std::uint32_t seen = 0;
+    std::uint32_t searching = 0;
+
+    // one searcher for every request, so that its threads and the copy of the options outlive a move
+    SearchOptions search_options = options;
+    search_options.should_stop = [this, &searching] {
+        return stopping.load(std::memory_order_relaxed) || wanted_id.load(std::memory_order_relaxed) != searching;
+    };
+    Expectimax search(search_options);
+
+    while (!stopping.load(std::memory_order_relaxed))
+    {
+        posted.wait(seen, std::memory_order_acquire);
+        seen = posted.load(std::memory_order_acquire);
+
+        // only the newest board matters
+        std::optional<Request> request;
+        Request item = {};
+
+        while (requests.TryPop(item))
+        {
+            request = item;
+        }
+
+        if (!request || request->id != wanted_id.load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        searching = request->id;
+        const auto found = search.BestMove(request->board);
+        searched_nodes.fetch_add(found.nodes, std::memory_order_relaxed);
+        CountEvent(Counter::SearchNodes, found.nodes);
+
+        if (found.aborted || !found.move)
+        {
+            continue;
+        }
+
+        const auto packed = (std::uint64_t{request->id} << 32) | (static_cast<std::uint64_t>(*found.move) + 1);
+        result.store(packed, std::memory_order_release);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "search.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+// Runs the search on its own thread so that the render loop never waits for it. The render thread posts board
+// snapshots through a lock-free queue and polls for the published move; posting a newer board, or cancelling,
+// stops the search that is still running for an older one.
+class AiWorker
+{
+  private:
+    struct Request
+    {
+        Board board;
+        std::uint32_t id;
+    };
+
+    static constexpr std::uint64_t NO_RESULT = 0;
+
+    SearchOptions options;
+    SpscQueue<Request, 16> requests;
+    // id of the only request whose result is still wanted
+    std::atomic<std::uint32_t> wanted_id = 0;
+    std::uint32_t next_id = 0;
+    // bumped on every post, the worker sleeps on it
+    std::atomic<std::uint32_t> posted = 0;
+    // request id in the high half, direction + 1 in the low half
+    std::atomic<std::uint64_t> result = NO_RESULT;
+    std::atomic<std::uint64_t> searched_nodes = 0;
+    std::atomic<bool> stopping = false;
+    std::jthread worker;
+
+  private:
+    void WorkerLoop();
+    void Wake();
+
+  public:
+    explicit AiWorker(SearchOptions options);
+    ~AiWorker();
+
+    AiWorker(const AiWorker &) = delete;
+    AiWorker(AiWorker &&) = delete;
+    auto operator=(const AiWorker &) -> AiWorker & = delete;
+    auto operator=(AiWorker &&) -> AiWorker & = delete;
+
+    // both called from the same (render) thread only
+    auto Post(Board board) -> std::uint32_t;
+    void Cancel();
+
+    // move found for request `id`, once the search is over
+    [[nodiscard]] auto Result(std::uint32_t id) const -> std::optional<Direction>;
+    [[nodiscard]] auto SearchedNodes() const -> std::uint64_t;
+};
@@ -1,38 +1,287 @@
 #include "app.h"
 #include "game_renderer.h"
+#include "resources.h"
+#include "trace.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <format>
+#include <future>
 #include <iostream>
+#include <thread>
+
+Application::Application(const ApplicationOptions &options) : options(options)
+{
+}
 
 void Application::Init()
 {
-    SDL_Init(SDL_INIT_VIDEO);
+    TRACE_SCOPE("Application::Init");
 
-    if (!SDL_CreateWindowAndRenderer("2048", app_layout.width, app_layout.height, 0, &window, &renderer))
-    {
-        throw std::runtime_error(SDL_GetError());
-    }
+    startup_mark = std::chrono::steady_clock::now();
 
     if (!TTF_Init())
     {
         throw std::runtime_error(SDL_GetError());
     }
 
-    const auto font_path = std::string(USER_FONT_PATH);
-    font = TTF_OpenFont(font_path.c_str(), 50);
+    // the font is parsed while the video subsystem and the window come up, it needs neither
+    auto font_loading = std::async(std::launch::async, [] { return OpenEmbeddedFont(50); });
 
-    if (!font)
+    SDL_Init(SDL_INIT_VIDEO);
+    MarkStartupPhase("video");
+
+    const auto window_flags = SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY;
+
+    if (!SDL_CreateWindowAndRenderer("2048", ApplicationLayout::DESIGN_WIDTH, ApplicationLayout::DESIGN_HEIGHT,
+                                     window_flags, &window, &renderer))
     {
         throw std::runtime_error(SDL_GetError());
     }
 
+    SDL_SetWindowMinimumSize(window, ApplicationLayout::DESIGN_WIDTH / 2, ApplicationLayout::DESIGN_HEIGHT / 2);
+    UpdateLayout();
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    MarkStartupPhase("window");
 
+    font = font_loading.get();
+    MarkStartupPhase("font");
+
+    // textures are made by the frames that first need them: atlases, digits and text alike
     game_renderer = std::make_unique<GameRenderer>(renderer, font);
+
+    if (options.spectate > 0)
+    {
+        // many shallow searches rather than a few deep ones, every game moves at the autoplay rate
+        SearchOptions spectator_options;
+        spectator_options.depth = 1;
+        spectator_options.threads = 1;
+        const auto threads = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+        const auto seed = static_cast<std::uint32_t>(SDL_GetTicksNS());
+
+        spectators = std::make_unique<SpectatorPool>(options.spectate, threads, options.autoplay_rate, seed,
+                                                     spectator_options);
+        spectator_boards.resize(options.spectate);
+        spectator_scores.resize(options.spectate);
+    }
+
+    // a table file that cannot be used ends the game here rather than at the first hint
+    if (!options.hash_file.empty())
+    {
+        table = std::make_unique<TranspositionTable>(options.hash_file, options.hash_megabytes, SEARCH_VALUES_VERSION);
+    }
+
+    if (!options.publish.empty())
+    {
+        publisher = std::make_unique<StatePublisher>(options.publish);
+    }
+
+    if (const auto session = storage.Load())
+    {
+        RestoreSession(game, *session);
+    }
+
+    PublishState();
+    MarkStartupPhase("game");
+}
+
+void Application::MarkStartupPhase(const std::string_view phase)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const std::chrono::duration<double, std::milli> elapsed = now - startup_mark;
+
+    startup_report += std::format("{}{} {:.1f} ms", startup_report.empty() ? "" : ", ", phase, elapsed.count());
+    startup_total += elapsed;
+    startup_mark = now;
+}
+
+void Application::StartAi()
+{
+    TRACE_SCOPE("Application::StartAi");
+
+    // the file-backed table is opened by Init, an anonymous one costs nothing until the search touches it
+    if (!table)
+    {
+        table = std::make_unique<TranspositionTable>(options.hash_megabytes, options.huge_pages);
+    }
+
+    SearchOptions search_options;
+    // a deadline bounds the latency of the hint whatever the board, the depth follows from it
+    search_options.depth = options.hint_ms > 0 ? MAX_AI_DEPTH : options.ai_depth;
+    search_options.time_budget = std::chrono::milliseconds(options.hint_ms);
+    search_options.table = table.get();
+    // keep one core for the render loop
+    search_options.threads = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+    ai = std::make_unique<AiWorker>(search_options);
+}
+
+void Application::UpdateLayout()
+{
+    // the output size is in pixels, so that high density displays get a scaled layout instead of a blurry one
+    int pixel_width = 0;
+    int pixel_height = 0;
+
+    if (!SDL_GetRenderOutputSize(renderer, &pixel_width, &pixel_height))
+    {
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    const bool resized = pixel_width != app_layout.width || pixel_height != app_layout.height;
+
+    if (resized)
+    {
+        app_layout = ApplicationLayout(pixel_width, pixel_height);
+        // a capture keeps the size it started with
+        StopCapture();
+    }
+
+    // the first call builds it even when the output has the design size
+    if (options.spectate > 0 && (resized || spectator_layout.grids.empty()))
+    {
+        spectator_layout = SpectatorLayout(options.spectate, pixel_width, pixel_height, app_layout.scale);
+    }
+}
+
+void Application::SaveSession()
+{
+    storage.SaveAsync(CaptureSession(game));
+    PublishState();
+}
+
+void Application::PublishState()
+{
+    // a few stores into shared memory, cheap enough for every change of the game
+    if (publisher)
+    {
+        publisher->Publish(TakeSnapshot(game));
+    }
+}
+
+void Application::RequestAiMove()
+{
+    // endless games can outgrow the packed board of the search
+    if ((show_hint || autoplay) && game.State() == GameState::Playing && CanPackGrid(game.GetGrid()))
+    {
+        // the table and the search threads wait for the first hint, most sessions never ask for one
+        if (!ai)
+        {
+            StartAi();
+        }
+
+        // a newer board supersedes the search still running for the previous one
+        ai_request = ai->Post(PackGrid(game.GetGrid()));
+    }
+    else
+    {
+        if (ai)
+        {
+            ai->Cancel();
+        }
+
+        ai_request = 0;
+    }
+}
+
+void Application::ApplyMove(const Direction dir)
+{
+    game.Move(dir);
+    game.Update();
+    SaveSession();
+    RequestAiMove();
+}
+
+void Application::UpdateAutoplay()
+{
+    if (!autoplay || ai_request == 0 || game.State() != GameState::Playing)
+    {
+        return;
+    }
+
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (now - last_autoplay_ns < static_cast<Uint64>(1e9 / options.autoplay_rate))
+    {
+        return;
+    }
+
+    // the worker publishes its move whenever it is ready, the loop never waits for it
+    if (const auto move = ai->Result(ai_request))
+    {
+        last_autoplay_ns = now;
+        ApplyMove(*move);
+    }
+}
+
+void Application::UpdateFrameStats()
+{
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (last_frame_ns != 0)
+    {
+        frame_stats.AddFrame(now - last_frame_ns, ReadCounters());
+    }
+
+    last_frame_ns = now;
+}
+
+void Application::ToggleCapture()
+{
+    if (capture)
+    {
+        StopCapture();
+        return;
+    }
+
+    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    const auto directory = DefaultCapturePath() / std::format("{:%Y%m%d-%H%M%S}", now);
+
+    // a capture that cannot start must not end the game
+    try
+    {
+        // leave the render loop and the AI most of the cores
+        const auto threads = std::max(std::thread::hardware_concurrency() / 4, 1U);
+        capture_writer = std::make_unique<FrameWriter>(directory, threads, 4 * static_cast<size_t>(threads));
+        capture = std::make_unique<FrameCapture>(renderer, app_layout.width, app_layout.height, *capture_writer);
+        std::cout << "capturing frames to " << directory.string() << '\n';
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        capture_writer.reset();
+    }
 }
 
-void Application::Quit() const
+void Application::StopCapture()
 {
+    if (!capture)
+    {
+        return;
+    }
+
+    try
+    {
+        capture->Flush();
+        capture_writer->Finish();
+        std::cout << capture_writer->Written() << " frames captured\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+    }
+
+    capture.reset();
+    capture_writer.reset();
+}
+
+void Application::Quit()
+{
+    StopCapture();
+    spectators.reset();
+
+    // the renderer's textures go before the renderer
+    game_renderer.reset();
+
     TTF_CloseFont(font);
     TTF_Quit();
 
@@ -48,28 +297,95 @@ void Application::Run()
     running = true;
 
     SDL_Event event;
+    bool first_frame = true;
 
     while (running)
     {
         PoolEvents(event);
+        UpdateAutoplay();
         Render();
+
+        if (first_frame)
+        {
+            MarkStartupPhase("first frame");
+            std::cout << std::format("started in {:.1f} ms: {}\n", startup_total.count(), startup_report);
+            first_frame = false;
+        }
+
         SDL_Delay(16);
+        UpdateFrameStats();
     }
 
+    SaveSession();
     Quit();
 }
 
 auto Application::HandleKeyDownEvent(const SDL_Event &event) -> bool
 {
+#ifdef C2048_TRACING
+    if (event.key.key == SDLK_F12)
+    {
+        // a trace that cannot be written must not end the game
+        try
+        {
+            WriteChromeTrace(DefaultTracePath());
+            std::cout << "trace written to " << DefaultTracePath().string() << '\n';
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << '\n';
+        }
+
+        return false;
+    }
+#endif
+
+    if (event.key.key == SDLK_F3)
+    {
+        show_overlay = !show_overlay;
+        return false;
+    }
+
+    if (event.key.key == SDLK_F9)
+    {
+        ToggleCapture();
+        return false;
+    }
+
+    // nothing to play while watching
+    if (spectators)
+    {
+        return false;
+    }
+
+    if (event.key.key == SDLK_H || event.key.key == SDLK_P)
+    {
+        (event.key.key == SDLK_H ? show_hint : autoplay) ^= true;
+        RequestAiMove();
+        return false;
+    }
+
     if (event.key.key == SDLK_R)
     {
         game.Reset();
+        SaveSession();
+        RequestAiMove();
         return false;
     }
 
     if (game.State() == GameState::Startup)
     {
         game.Start();
+        SaveSession();
+        RequestAiMove();
+        return false;
+    }
+
+    if (game.State() == GameState::Victory && event.key.key == SDLK_C)
+    {
+        game.Continue();
+        SaveSession();
+        RequestAiMove();
         return false;
     }
 
@@ -82,30 +398,31 @@ auto Application::HandleKeyDownEvent(const SDL_Event &event) -> bool
     {
     case SDLK_DOWN:
     case SDLK_S:
-        game.Move(Direction::DOWN);
+        ApplyMove(Direction::DOWN);
         break;
     case SDLK_UP:
     case SDLK_W:
-        game.Move(Direction::UP);
+        ApplyMove(Direction::UP);
         break;
     case SDLK_LEFT:
     case SDLK_A:
-        game.Move(Direction::LEFT);
+        ApplyMove(Direction::LEFT);
         break;
     case SDLK_RIGHT:
     case SDLK_D:
-        game.Move(Direction::RIGHT);
+        ApplyMove(Direction::RIGHT);
         break;
     default:
         return false;
     }
 
-    game.Update();
     return false;
 }
 
 void Application::PoolEvents(SDL_Event &event)
 {
+    TRACE_SCOPE("Application::PoolEvents");
+
     while (SDL_PollEvent(&event))
     {
         if (event.type == SDL_EVENT_QUIT)
@@ -114,6 +431,29 @@ void Application::PoolEvents(SDL_Event &event)
             break;
         }
 
+        // covers both resizes and moves to a display of another density
+        if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED)
+        {
+            UpdateLayout();
+            continue;
+        }
+
+        // the contents of target textures are lost with the targets, every texture with the device
+        if (event.type == SDL_EVENT_RENDER_TARGETS_RESET)
+        {
+            StopCapture();
+            game_renderer->InvalidateTileAtlas();
+            continue;
+        }
+
+        if (event.type == SDL_EVENT_RENDER_DEVICE_RESET)
+        {
+            StopCapture();
+            game_renderer->InvalidateTileAtlas();
+            game_renderer->ClearTextCache();
+            continue;
+        }
+
         if (event.type == SDL_EVENT_KEY_DOWN && HandleKeyDownEvent(event))
         {
             break;
@@ -123,12 +463,67 @@ void Application::PoolEvents(SDL_Event &event)
 
 void Application::Render()
 {
+    TRACE_SCOPE("Application::Render");
+
+    if (capture)
+    {
+        capture->BeginFrame();
+    }
+
     SDL_RenderClear(renderer);
 
+    if (spectators)
+    {
+        DrawSpectators();
+    }
+    else
+    {
+        DrawGame();
+    }
+
+    if (show_overlay)
+    {
+        game_renderer->DrawOverlay(frame_stats, app_layout.overlay_layout);
+    }
+
+    // the window shows the frame it captured
+    if (capture)
+    {
+        // like one that cannot start, a capture that fails stops and the game goes on
+        try
+        {
+            capture->EndFrame();
+            SDL_RenderTexture(renderer, capture->LastFrame(), nullptr, nullptr);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "capture stopped: " << e.what() << '\n';
+            SDL_SetRenderTarget(renderer, nullptr);
+            StopCapture();
+        }
+    }
+
+    // display
+    SDL_RenderPresent(renderer);
+    game_renderer->EndFrame();
+}
+
+void Application::DrawGame()
+{
     game_renderer->DrawBackground(app_layout.grid_layout.bg_color);
     game_renderer->DrawScoreBoard(game.Score(), game.BestScore(), app_layout.score_board_layout);
     game_renderer->DrawGrid(game.GetGrid(), app_layout.grid_layout);
 
+    if (show_hint || autoplay)
+    {
+        const auto move = ai_request != 0 ? ai->Result(ai_request) : std::nullopt;
+        const auto label = autoplay ? "Autoplay" : "Hint";
+        // no request: the board is beyond what the search can pack
+        const auto status = move ? DirectionName(*move) : ai_request == 0 ? "-" : "...";
+        const auto hint = std::format("{}: {}", label, status);
+        game_renderer->DrawHint(hint, app_layout.score_board_layout);
+    }
+
     const auto state = game.State();
 
     if (state == GameState::Startup)
@@ -139,7 +534,17 @@ void Application::Render()
     {
         game_renderer->DrawEndGameMessage(app_layout.message_layout, state);
     }
+}
+
+void Application::DrawSpectators()
+{
+    for (size_t i = 0; i < spectators->Size(); ++i)
+    {
+        const auto snapshot = spectators->Get(i);
+        spectator_boards[i] = snapshot.board;
+        spectator_scores[i] = snapshot.score;
+    }
 
-    // display
-    SDL_RenderPresent(renderer);
+    game_renderer->DrawBackground(spectator_layout.bg_color);
+    game_renderer->DrawBoards(spectator_boards, spectator_scores, spectator_layout);
 }
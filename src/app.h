@@ -1,31 +1,83 @@
 #pragma once
 
+#include "ai_worker.h"
+#include "counters.h"
+#include "frame_capture.h"
+#include "frame_stats.h"
+#include "frame_writer.h"
 #include "game.h"
 #include "game_renderer.h"
 #include "layout.h"
+#include "options.h"
+#include "shared_state.h"
+#include "spectator.h"
+#include "storage.h"
+#include "transposition_table.h"
 
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 struct Application
 {
   private:
+    ApplicationOptions options;
     Game game;
     TTF_Font *font = nullptr;
     SDL_Window *window = nullptr;
     SDL_Renderer *renderer = nullptr;
     ApplicationLayout app_layout;
     std::unique_ptr<GameRenderer> game_renderer;
+    Storage storage{DefaultStoragePath()};
+    std::unique_ptr<StatePublisher> publisher;
+    std::unique_ptr<TranspositionTable> table;
+    std::unique_ptr<AiWorker> ai;
+    // spectator view: the games, their layout and the snapshot of every frame, reused so that drawing does not allocate
+    std::unique_ptr<SpectatorPool> spectators;
+    SpectatorLayout spectator_layout;
+    std::vector<Board> spectator_boards;
+    std::vector<std::uint32_t> spectator_scores;
+    // F9 records every frame as a PNG, encoded on the writer's threads
+    std::unique_ptr<FrameWriter> capture_writer;
+    std::unique_ptr<FrameCapture> capture;
+    std::uint32_t ai_request = 0;
+    Uint64 last_autoplay_ns = 0;
+    FrameStats frame_stats{ReadCounters()};
+    Uint64 last_frame_ns = 0;
+    bool show_overlay = false;
+    bool show_hint = false;
+    bool autoplay = false;
     bool running = false;
+    // time from Init to the first frame, by phase, printed once it is on screen
+    std::chrono::steady_clock::time_point startup_mark;
+    std::chrono::duration<double, std::milli> startup_total{};
+    std::string startup_report;
 
   private:
     void Init();
-    void Quit() const;
+    void Quit();
+    void MarkStartupPhase(std::string_view phase);
+    void StartAi();
     void PoolEvents(SDL_Event &event);
     auto HandleKeyDownEvent(const SDL_Event &event) -> bool;
     void Render();
+    void DrawGame();
+    void DrawSpectators();
+    void ToggleCapture();
+    void StopCapture();
+    void UpdateLayout();
+    void SaveSession();
+    void PublishState();
+    void ApplyMove(Direction dir);
+    void RequestAiMove();
+    void UpdateAutoplay();
+    void UpdateFrameStats();
 
   public:
+    explicit Application(const ApplicationOptions &options);
     void Run();
 };
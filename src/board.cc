@@ -0,0 +1,402 @@
+#include "board.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include <stdexcept>
+
+// Moving a row only depends on its 16 bits, so every move is precomputed for the 65536 possible rows.
+struct RowTables
+{
+    std::array<BoardRow, 65536> left = {};
+    std::array<BoardRow, 65536> right = {};
+    std::array<std::uint32_t, 65536> score = {};
+};
+
+auto ReverseRow(const BoardRow row) -> BoardRow
+{
+    return static_cast<BoardRow>((row >> 12) | ((row >> 4) & 0x00f0) | ((row << 4) & 0x0f00) | (row << 12));
+}
+
+auto SlideRowLeft(const BoardRow row, std::uint32_t &score) -> BoardRow
+{
+    std::array<std::uint8_t, BOARD_SIZE> line = {};
+    size_t write_pos = 0;
+    bool last_merged = false;
+
+    for (size_t col = 0; col < BOARD_SIZE; ++col)
+    {
+        const auto exponent = static_cast<std::uint8_t>((row >> (4 * col)) & 0xf);
+
+        // skip empty tiles
+        if (exponent == 0)
+        {
+            continue;
+        }
+
+        // a tile merges at most once per move, and the largest tile has no room to grow
+        if (write_pos > 0 && !last_merged && line.at(write_pos - 1) == exponent && exponent < MAX_EXPONENT)
+        {
+            ++line.at(write_pos - 1);
+            score += ExponentToValue(line.at(write_pos - 1));
+            last_merged = true;
+            continue;
+        }
+
+        line.at(write_pos++) = exponent;
+        last_merged = false;
+    }
+
+    BoardRow result = 0;
+
+    for (size_t col = 0; col < BOARD_SIZE; ++col)
+    {
+        result |= static_cast<BoardRow>(line.at(col) << (4 * col));
+    }
+
+    return result;
+}
+
+auto BuildRowTables() -> RowTables
+{
+    RowTables tables;
+
+    for (size_t row = 0; row < tables.left.size(); ++row)
+    {
+        std::uint32_t score = 0;
+        const auto left = SlideRowLeft(static_cast<BoardRow>(row), score);
+        const auto reversed = ReverseRow(static_cast<BoardRow>(row));
+
+        tables.left.at(row) = left;
+        tables.score.at(row) = score;
+
+        std::uint32_t reversed_score = 0;
+        tables.right.at(row) = ReverseRow(SlideRowLeft(reversed, reversed_score));
+    }
+
+    return tables;
+}
+
+auto GetRowTables() -> const RowTables &
+{
+    static const RowTables tables = BuildRowTables();
+    return tables;
+}
+
+auto ValueToExponent(const std::uint32_t value) -> std::uint8_t
+{
+    if (value == 0)
+    {
+        return 0;
+    }
+
+    const auto exponent = std::countr_zero(value);
+
+    if (!std::has_single_bit(value) || exponent > MAX_EXPONENT)
+    {
+        throw std::out_of_range(std::format("{} cannot be stored in a packed board", value));
+    }
+
+    return static_cast<std::uint8_t>(exponent);
+}
+
+auto ExponentToValue(const std::uint8_t exponent) -> std::uint32_t
+{
+    return exponent == 0 ? 0 : std::uint32_t{1} << exponent;
+}
+
+auto CanPackGrid(const Grid &grid) -> bool
+{
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            if (grid.GetTile(row, col).value > ExponentToValue(MAX_EXPONENT))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+auto PackGrid(const Grid &grid) -> Board
+{
+    Board board = 0;
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            board = SetCell(board, row * BOARD_SIZE + col, ValueToExponent(grid.GetTile(row, col).value));
+        }
+    }
+
+    return board;
+}
+
+void UnpackGrid(const Board board, Grid &grid)
+{
+    grid.Init();
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            grid.SetTile(row, col, static_cast<int>(ExponentToValue(GetCell(board, row * BOARD_SIZE + col))));
+        }
+    }
+}
+
+auto Transpose(const Board board) -> Board
+{
+    // swap the 1x1 blocks of every 2x2 block, then the 2x2 blocks of the 4x4 board
+    const Board a1 = board & 0xf0f00f0ff0f00f0f;
+    const Board a2 = board & 0x0000f0f00000f0f0;
+    const Board a3 = board & 0x0f0f00000f0f0000;
+    const Board a = a1 | (a2 << 12) | (a3 >> 12);
+
+    const Board b1 = a & 0xff00ff0000ff00ff;
+    const Board b2 = a & 0x00ff00ff00000000;
+    const Board b3 = a & 0x00000000ff00ff00;
+
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+auto FlipHorizontal(const Board board) -> Board
+{
+    // swap the nibbles of every byte, then the bytes of every row
+    const Board nibbles = ((board & 0x0f0f0f0f0f0f0f0f) << 4) | ((board >> 4) & 0x0f0f0f0f0f0f0f0f);
+    return ((nibbles & 0x00ff00ff00ff00ff) << 8) | ((nibbles >> 8) & 0x00ff00ff00ff00ff);
+}
+
+auto FlipVertical(const Board board) -> Board
+{
+    // swap the rows of every half, then the halves
+    const Board rows = ((board & 0x0000ffff0000ffff) << 16) | ((board >> 16) & 0x0000ffff0000ffff);
+    return (rows << 32) | (rows >> 32);
+}
+
+auto ApplySymmetry(Board board, const size_t symmetry) -> Board
+{
+    if (symmetry & 1)
+    {
+        board = FlipHorizontal(board);
+    }
+
+    if (symmetry & 2)
+    {
+        board = FlipVertical(board);
+    }
+
+    if (symmetry & 4)
+    {
+        board = Transpose(board);
+    }
+
+    return board;
+}
+
+auto FlipDirection(const Direction dir, const Direction a, const Direction b) -> Direction
+{
+    if (dir == a)
+    {
+        return b;
+    }
+
+    return dir == b ? a : dir;
+}
+
+auto TransposeDirection(const Direction dir) -> Direction
+{
+    switch (dir)
+    {
+    case Direction::UP:
+        return Direction::LEFT;
+    case Direction::LEFT:
+        return Direction::UP;
+    case Direction::DOWN:
+        return Direction::RIGHT;
+    case Direction::RIGHT:
+    default:
+        return Direction::DOWN;
+    }
+}
+
+auto ApplySymmetry(Direction dir, const size_t symmetry) -> Direction
+{
+    if (symmetry & 1)
+    {
+        dir = FlipDirection(dir, Direction::LEFT, Direction::RIGHT);
+    }
+
+    if (symmetry & 2)
+    {
+        dir = FlipDirection(dir, Direction::UP, Direction::DOWN);
+    }
+
+    if (symmetry & 4)
+    {
+        dir = TransposeDirection(dir);
+    }
+
+    return dir;
+}
+
+auto InvertSymmetry(Direction dir, const size_t symmetry) -> Direction
+{
+    // every step is its own inverse, undo them in reverse order
+    if (symmetry & 4)
+    {
+        dir = TransposeDirection(dir);
+    }
+
+    if (symmetry & 2)
+    {
+        dir = FlipDirection(dir, Direction::UP, Direction::DOWN);
+    }
+
+    if (symmetry & 1)
+    {
+        dir = FlipDirection(dir, Direction::LEFT, Direction::RIGHT);
+    }
+
+    return dir;
+}
+
+auto Symmetries(const Board board) -> std::array<Board, BOARD_SYMMETRIES>
+{
+    const Board h = FlipHorizontal(board);
+    const Board v = FlipVertical(board);
+    const Board hv = FlipVertical(h);
+
+    return {board, h, v, hv, Transpose(board), Transpose(h), Transpose(v), Transpose(hv)};
+}
+
+auto Canonicalize(const Board board) -> CanonicalBoard
+{
+    const auto boards = Symmetries(board);
+    CanonicalBoard canonical = {board, 0};
+
+    for (size_t symmetry = 1; symmetry < BOARD_SYMMETRIES; ++symmetry)
+    {
+        if (boards[symmetry] < canonical.board)
+        {
+            canonical = {boards[symmetry], symmetry};
+        }
+    }
+
+    return canonical;
+}
+
+auto MoveRows(const Board board, const std::array<BoardRow, 65536> &table) -> MoveResult
+{
+    const auto &tables = GetRowTables();
+    MoveResult result = {0, 0};
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        const auto line = GetRow(board, row);
+        result.board |= Board{table[line]} << (16 * row);
+        result.score += tables.score[line];
+    }
+
+    return result;
+}
+
+auto MoveBoard(const Board board, const Direction dir) -> MoveResult
+{
+    const auto &tables = GetRowTables();
+
+    switch (dir)
+    {
+    case Direction::LEFT:
+        return MoveRows(board, tables.left);
+    case Direction::RIGHT:
+        return MoveRows(board, tables.right);
+    case Direction::UP: {
+        // columns become rows once transposed, and moving up is moving them left
+        auto result = MoveRows(Transpose(board), tables.left);
+        result.board = Transpose(result.board);
+        return result;
+    }
+    case Direction::DOWN:
+    default: {
+        auto result = MoveRows(Transpose(board), tables.right);
+        result.board = Transpose(result.board);
+        return result;
+    }
+    }
+}
+
+auto CountEmpty(const Board board) -> int
+{
+    // fold every nibble into its lowest bit: the bit is set when the cell is not empty
+    Board occupied = board | (board >> 1);
+    occupied |= occupied >> 2;
+    occupied &= 0x1111111111111111;
+
+    return static_cast<int>(BOARD_CELLS) - std::popcount(occupied);
+}
+
+auto MaxExponent(const Board board) -> std::uint8_t
+{
+    std::uint8_t max_exponent = 0;
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        max_exponent = std::max(max_exponent, GetCell(board, i));
+    }
+
+    return max_exponent;
+}
+
+auto TileSum(const Board board) -> std::uint32_t
+{
+    std::uint32_t sum = 0;
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        sum += ExponentToValue(GetCell(board, i));
+    }
+
+    return sum;
+}
+
+template <typename Generator> auto SpawnWith(const Board board, Generator &gen) -> Board
+{
+    const int n_empty = CountEmpty(board);
+
+    if (n_empty == 0)
+    {
+        return board;
+    }
+
+    std::uniform_int_distribution<int> index_dist(0, n_empty - 1);
+    std::discrete_distribution val_dist({PROB_2, PROB_4});
+
+    int target = index_dist(gen);
+    const auto exponent = static_cast<std::uint8_t>(val_dist(gen) == 0 ? 1 : 2);
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        if (GetCell(board, i) == 0 && target-- == 0)
+        {
+            return SetCell(board, i, exponent);
+        }
+    }
+
+    return board;
+}
+
+auto SpawnRandom(const Board board, std::mt19937 &gen) -> Board
+{
+    return SpawnWith(board, gen);
+}
+
+auto SpawnRandom(const Board board, CompactRng &gen) -> Board
+{
+    return SpawnWith(board, gen);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "game.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// A 4x4 board packed in 64 bits. Every cell stores the exponent of its tile in 4 bits (0 = empty), row-major,
+// with cell (0, 0) in the least significant nibble: row r lives in bits [16r, 16r + 16).
+using Board = std::uint64_t;
+using BoardRow = std::uint16_t;
+
+constexpr size_t BOARD_SIZE = 4;
+constexpr size_t BOARD_CELLS = BOARD_SIZE * BOARD_SIZE;
+constexpr std::uint8_t MAX_EXPONENT = 15;
+constexpr size_t BOARD_SYMMETRIES = 8;
+
+struct MoveResult
+{
+    Board board;
+    std::uint32_t score;
+};
+
+constexpr auto GetCell(const Board board, const size_t index) -> std::uint8_t
+{
+    return static_cast<std::uint8_t>((board >> (4 * index)) & 0xf);
+}
+
+constexpr auto SetCell(const Board board, const size_t index, const std::uint8_t exponent) -> Board
+{
+    const auto shift = 4 * index;
+    return (board & ~(Board{0xf} << shift)) | (Board{exponent} << shift);
+}
+
+constexpr auto GetRow(const Board board, const size_t row) -> BoardRow
+{
+    return static_cast<BoardRow>(board >> (16 * row));
+}
+
+auto ValueToExponent(std::uint32_t value) -> std::uint8_t;
+auto ExponentToValue(std::uint8_t exponent) -> std::uint32_t;
+
+// false when a tile is above 2^MAX_EXPONENT, which endless games reach
+auto CanPackGrid(const Grid &grid) -> bool;
+auto PackGrid(const Grid &grid) -> Board;
+void UnpackGrid(Board board, Grid &grid);
+
+auto Transpose(Board board) -> Board;
+auto FlipHorizontal(Board board) -> Board;
+auto FlipVertical(Board board) -> Board;
+
+// Symmetry s mirrors the columns when bit 0 is set, the rows when bit 1 is set, then transposes when bit 2 is set.
+auto ApplySymmetry(Board board, size_t symmetry) -> Board;
+auto ApplySymmetry(Direction dir, size_t symmetry) -> Direction;
+auto InvertSymmetry(Direction dir, size_t symmetry) -> Direction;
+auto Symmetries(Board board) -> std::array<Board, BOARD_SYMMETRIES>;
+
+struct CanonicalBoard
+{
+    Board board;
+    // symmetry that maps the original board to the canonical one
+    size_t symmetry;
+};
+
+// The smallest of the 8 symmetric boards: rotated and mirrored positions share one cache entry.
+auto Canonicalize(Board board) -> CanonicalBoard;
+auto MoveBoard(Board board, Direction dir) -> MoveResult;
+auto CountEmpty(Board board) -> int;
+auto MaxExponent(Board board) -> std::uint8_t;
+auto TileSum(Board board) -> std::uint32_t;
+
+// xorshift32: 4 bytes of state instead of the 5 KB of std::mt19937, for places that hold many games at once.
+class CompactRng
+{
+  private:
+    std::uint32_t state;
+
+  public:
+    using result_type = std::uint32_t;
+
+    // xorshift never leaves the all-zero state, so that seed is remapped
+    explicit constexpr CompactRng(const std::uint32_t seed) : state(seed != 0 ? seed : 0x9e3779b9)
+    {
+    }
+
+    static constexpr auto min() -> result_type
+    {
+        return 1;
+    }
+
+    static constexpr auto max() -> result_type
+    {
+        return 0xffffffff;
+    }
+
+    constexpr auto operator()() -> result_type
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+// Spawns a 2 or a 4 in a random empty cell with the same odds as Game::Spawn.
+auto SpawnRandom(Board board, std::mt19937 &gen) -> Board;
+auto SpawnRandom(Board board, CompactRng &gen) -> Board;
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "board.h"
+#include "game.h"
+#include "rules.h"
+
+#include <cstdint>
+
+// The rules of a policy from rules.h on a packed board with a 4-byte random generator: 24 bytes per game instead of
+// the kilobytes of a Grid and a std::mt19937, for hosts that keep thousands of games alive.
+template <typename Rules> class BasicCompactGame
+{
+  private:
+    using Kernel = RuleKernel<Rules>;
+
+    Board board = 0;
+    std::uint32_t score = 0;
+    CompactRng gen;
+    GameState state = GameState::Startup;
+
+  private:
+    void UpdateState()
+    {
+        // same order as Game::Update: a full board wins over a winning tile
+        if (!Kernel::HasMoves(board))
+        {
+            state = GameState::GameOver;
+        }
+        else if (Kernel::HasWon(board))
+        {
+            state = GameState::Victory;
+        }
+    }
+
+  public:
+    explicit BasicCompactGame(const std::uint32_t seed) : gen(seed)
+    {
+    }
+
+    void Start()
+    {
+        board = Kernel::StartBoard(gen);
+        score = 0;
+        state = GameState::Playing;
+    }
+
+    // slides the tiles then spawns one, false when the move changes nothing or the game is over
+    auto Move(const Direction dir) -> bool
+    {
+        if (state != GameState::Playing)
+        {
+            return false;
+        }
+
+        const auto [moved, gained] = Kernel::Move(board, dir);
+
+        if (moved == board)
+        {
+            return false;
+        }
+
+        board = Kernel::Spawn(moved, gen);
+        score += gained;
+        UpdateState();
+        return true;
+    }
+
+    [[nodiscard]] auto GetBoard() const -> Board
+    {
+        return board;
+    }
+
+    [[nodiscard]] auto Score() const -> std::uint32_t
+    {
+        return score;
+    }
+
+    [[nodiscard]] auto State() const -> GameState
+    {
+        return state;
+    }
+};
+
+using CompactGame = BasicCompactGame<ClassicRules>;
+
+static_assert(sizeof(CompactGame) <= 24);
@@ -0,0 +1,46 @@
+#include "counters.h"
+
+#include <atomic>
+
+struct alignas(64) PaddedCounter
+{
+    std::atomic<std::uint64_t> value = 0;
+};
+
+std::array<PaddedCounter, COUNTERS> counters;
+
+void CountEvent(const Counter counter, const std::uint64_t amount)
+{
+    counters[static_cast<size_t>(counter)].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+auto ReadCounter(const Counter counter) -> std::uint64_t
+{
+    return counters[static_cast<size_t>(counter)].value.load(std::memory_order_relaxed);
+}
+
+auto ReadCounters() -> CounterValues
+{
+    CounterValues values = {};
+
+    for (size_t i = 0; i < COUNTERS; ++i)
+    {
+        values[i] = ReadCounter(static_cast<Counter>(i));
+    }
+
+    return values;
+}
+
+auto CounterName(const Counter counter) -> std::string_view
+{
+    switch (counter)
+    {
+    case Counter::TextRasterizations:
+        return "text rasterizations";
+    case Counter::TextureCreations:
+        return "texture creations";
+    case Counter::SearchNodes:
+    default:
+        return "search nodes";
+    }
+}
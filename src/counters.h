@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class Counter : std::uint8_t
+{
+    TextRasterizations,
+    TextureCreations,
+    SearchNodes,
+};
+
+constexpr size_t COUNTERS = 3;
+
+using CounterValues = std::array<std::uint64_t, COUNTERS>;
+
+// Process-wide event counters. Counting is a relaxed atomic add on a cache line of its own, cheap enough for the
+// render loop; hot loops such as the search add their totals once per batch.
+void CountEvent(Counter counter, std::uint64_t amount = 1);
+auto ReadCounter(Counter counter) -> std::uint64_t;
+auto ReadCounters() -> CounterValues;
+auto CounterName(Counter counter) -> std::string_view;
@@ -0,0 +1,196 @@
+#include "differential.h"
+#include "rules.h"
+
+#include <array>
+#include <format>
+#include <random>
+
+auto MoveEngines() -> std::span<const MoveEngine>
+{
+    static const std::array engines = {
+        MoveEngine{"MoveBoard", MoveBoard},
+        MoveEngine{"RuleKernel<ClassicRules>", RuleKernel<ClassicRules>::Move},
+    };
+
+    return engines;
+}
+
+auto ReferenceMove(const Board board, const Direction dir) -> std::optional<MoveResult>
+{
+    // one game per thread: constructing a Game seeds a std::mt19937, which costs more than the move
+    thread_local Game game(0);
+
+    UnpackGrid(board, game.GetGrid());
+    const auto before = game.Score();
+    game.Move(dir);
+
+    if (!CanPackGrid(game.GetGrid()))
+    {
+        return std::nullopt;
+    }
+
+    return MoveResult{PackGrid(game.GetGrid()), static_cast<std::uint32_t>(game.Score() - before)};
+}
+
+auto Diverges(const MoveEngine &engine, const Board board, const Direction dir) -> std::optional<Counterexample>
+{
+    const auto expected = ReferenceMove(board, dir);
+
+    if (!expected)
+    {
+        return std::nullopt;
+    }
+
+    const auto actual = engine.move(board, dir);
+
+    if (actual.board == expected->board && actual.score == expected->score)
+    {
+        return std::nullopt;
+    }
+
+    return Counterexample{std::string(engine.name), board, dir, *expected, actual};
+}
+
+auto FormatCounterexample(const Counterexample &counterexample) -> std::string
+{
+    const auto &[engine, board, dir, expected, actual] = counterexample;
+
+    auto text = std::format("{} diverges on {} from {:016x}: expected {:016x} (+{}), got {:016x} (+{})\n", engine,
+                            DirectionName(dir), board, expected.board, expected.score, actual.board, actual.score);
+
+    // the board as exponents, row 0 first
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            text += std::format("{:>3}", GetCell(board, row * BOARD_SIZE + col));
+        }
+
+        text += '\n';
+    }
+
+    return text;
+}
+
+auto CheckCase(const MoveEngine &engine, const DifferentialCase &test_case, std::uint64_t &checked)
+    -> std::optional<Counterexample>
+{
+    Board board = test_case.start;
+
+    for (const auto [dir, spawn_cell] : test_case.steps)
+    {
+        const auto expected = ReferenceMove(board, dir);
+
+        if (!expected)
+        {
+            return std::nullopt;
+        }
+
+        ++checked;
+
+        if (const auto actual = engine.move(board, dir); actual.board != expected->board ||
+                                                            actual.score != expected->score)
+        {
+            return Counterexample{std::string(engine.name), board, dir, *expected, actual};
+        }
+
+        board = expected->board;
+
+        if (GetCell(board, spawn_cell) == 0)
+        {
+            board = SetCell(board, spawn_cell, 1);
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto MinimizeCounterexample(const MoveEngine &engine, Counterexample counterexample) -> Counterexample
+{
+    bool shrunk = true;
+
+    while (shrunk)
+    {
+        shrunk = false;
+
+        for (size_t cell = 0; cell < BOARD_CELLS && !shrunk; ++cell)
+        {
+            const auto exponent = GetCell(counterexample.board, cell);
+
+            if (exponent == 0)
+            {
+                continue;
+            }
+
+            // an empty cell first, then a smaller tile
+            for (const auto smaller : {std::uint8_t{0}, static_cast<std::uint8_t>(exponent - 1)})
+            {
+                const auto candidate = SetCell(counterexample.board, cell, smaller);
+
+                if (const auto diverging = Diverges(engine, candidate, counterexample.dir))
+                {
+                    counterexample = *diverging;
+                    shrunk = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return counterexample;
+}
+
+// Small exponent ranges make equal neighbours, and so merges and merge chains, common.
+auto RandomDifferentialBoard(std::mt19937 &gen) -> Board
+{
+    std::uniform_int_distribution<int> top_dist(1, MAX_EXPONENT);
+    std::uniform_int_distribution<int> small_top_dist(1, 3);
+    std::bernoulli_distribution small_dist(0.5);
+    std::bernoulli_distribution empty_dist(0.3);
+
+    const int top = small_dist(gen) ? small_top_dist(gen) : top_dist(gen);
+    std::uniform_int_distribution<int> exponent_dist(1, top);
+    Board board = 0;
+
+    for (size_t cell = 0; cell < BOARD_CELLS; ++cell)
+    {
+        if (!empty_dist(gen))
+        {
+            board = SetCell(board, cell, static_cast<std::uint8_t>(exponent_dist(gen)));
+        }
+    }
+
+    return board;
+}
+
+auto RunDifferential(const MoveEngine &engine, const std::uint64_t cases, const std::uint32_t seed)
+    -> DifferentialReport
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dir_dist(0, 3);
+    std::uniform_int_distribution<int> cell_dist(0, BOARD_CELLS - 1);
+    std::uniform_int_distribution<int> length_dist(1, 16);
+
+    DifferentialReport report;
+    DifferentialCase test_case;
+
+    for (; report.cases < cases; ++report.cases)
+    {
+        test_case.start = RandomDifferentialBoard(gen);
+        test_case.steps.resize(length_dist(gen));
+
+        for (auto &step : test_case.steps)
+        {
+            step = {static_cast<Direction>(dir_dist(gen)), static_cast<std::uint8_t>(cell_dist(gen))};
+        }
+
+        if (const auto counterexample = CheckCase(engine, test_case, report.moves))
+        {
+            report.counterexample = MinimizeCounterexample(engine, *counterexample);
+            ++report.cases;
+            break;
+        }
+    }
+
+    return report;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "board.h"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Differential testing of move engines against the rules of Game. Game::MoveRow and Game::MoveCol are the
+// reference: a tile merges at most once per move, tiles merge starting from the side they slide to, and a move
+// scores the sum of the merged tiles. Every faster engine must reproduce them exactly on packed boards.
+
+using MoveFunction = std::function<MoveResult(Board, Direction)>;
+
+struct MoveEngine
+{
+    std::string_view name;
+    MoveFunction move;
+};
+
+// The engines under test, checked by 2048_difftest, the fuzzer and the tests.
+auto MoveEngines() -> std::span<const MoveEngine>;
+
+// The move as Game plays it. Nothing when the result no longer fits a packed board (a merge above 2^MAX_EXPONENT),
+// which is outside of what packed engines represent.
+auto ReferenceMove(Board board, Direction dir) -> std::optional<MoveResult>;
+
+// One move of a case, then a 2 spawned in `spawn_cell` when that cell is empty.
+struct DifferentialStep
+{
+    Direction dir;
+    std::uint8_t spawn_cell;
+};
+
+struct DifferentialCase
+{
+    Board start = 0;
+    std::vector<DifferentialStep> steps;
+};
+
+struct Counterexample
+{
+    std::string engine;
+    Board board = 0;
+    Direction dir = Direction::UP;
+    MoveResult expected = {};
+    MoveResult actual = {};
+};
+
+auto FormatCounterexample(const Counterexample &counterexample) -> std::string;
+
+// Plays the case on the reference and the engine side by side, the first diverging move if any. `checked` counts the
+// moves compared: a case stops early where the reference leaves the packed domain.
+auto CheckCase(const MoveEngine &engine, const DifferentialCase &test_case, std::uint64_t &checked)
+    -> std::optional<Counterexample>;
+
+// Shrinks a counterexample while it still diverges: removes tiles, then lowers them.
+auto MinimizeCounterexample(const MoveEngine &engine, Counterexample counterexample) -> Counterexample;
+
+struct DifferentialReport
+{
+    std::uint64_t cases = 0;
+    std::uint64_t moves = 0;
+    std::optional<Counterexample> counterexample;
+};
+
+// Random cases, biased towards boards with many equal neighbours, until `cases` ran or a minimized counterexample
+// was found.
+auto RunDifferential(const MoveEngine &engine, std::uint64_t cases, std::uint32_t seed) -> DifferentialReport;
@@ -0,0 +1,130 @@
+#include "frame_capture.h"
+#include "counters.h"
+#include "trace.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+FrameCapture::FrameCapture(SDL_Renderer *renderer, const int width, const int height, FrameWriter &writer)
+    : renderer(renderer), writer(writer), width(width), height(height)
+{
+    for (auto &target : targets)
+    {
+        target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, width, height);
+        CountEvent(Counter::TextureCreations);
+    }
+
+    if (!targets[0] || !targets[1])
+    {
+        const std::string error = SDL_GetError();
+        // the destructor does not run for an object that was never constructed
+        for (auto *target : targets)
+        {
+            SDL_DestroyTexture(target);
+        }
+
+        throw std::runtime_error("unable to create the capture targets: " + error);
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    for (auto &target : targets)
+    {
+        if (target)
+        {
+            SDL_DestroyTexture(target);
+            target = nullptr;
+        }
+    }
+}
+
+void FrameCapture::BeginFrame()
+{
+    window_target = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, targets[current]);
+}
+
+void FrameCapture::EndFrame()
+{
+    TRACE_SCOPE("FrameCapture::EndFrame");
+
+    // the previous frame is complete by now, reading it does not wait for the one just submitted
+    if (previous_pending)
+    {
+        ReadBack(targets[current ^ 1]);
+    }
+
+    SDL_SetRenderTarget(renderer, window_target);
+    previous_pending = true;
+    current ^= 1;
+}
+
+void FrameCapture::Flush()
+{
+    if (previous_pending)
+    {
+        SDL_Texture *previous_target = SDL_GetRenderTarget(renderer);
+        ReadBack(targets[current ^ 1]);
+        SDL_SetRenderTarget(renderer, previous_target);
+        previous_pending = false;
+    }
+}
+
+auto FrameCapture::LastFrame() const -> SDL_Texture *
+{
+    return targets[current ^ 1];
+}
+
+auto FrameCapture::Width() const -> int
+{
+    return width;
+}
+
+auto FrameCapture::Height() const -> int
+{
+    return height;
+}
+
+void FrameCapture::ReadBack(SDL_Texture *target)
+{
+    TRACE_SCOPE("FrameCapture::ReadBack");
+
+    // the renderer reads from its current target
+    SDL_SetRenderTarget(renderer, target);
+    SDL_Surface *surface = SDL_RenderReadPixels(renderer, nullptr);
+
+    if (!surface)
+    {
+        throw std::runtime_error(std::string("unable to read a captured frame: ") + SDL_GetError());
+    }
+
+    // the renderer picks the format of what it reads, the encoder wants RGBA bytes
+    if (surface->format != SDL_PIXELFORMAT_RGBA32)
+    {
+        SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(surface);
+        surface = converted;
+
+        if (!surface)
+        {
+            throw std::runtime_error(std::string("unable to convert a captured frame: ") + SDL_GetError());
+        }
+    }
+
+    const auto row_bytes = static_cast<size_t>(surface->w) * 4;
+    const auto rows = static_cast<size_t>(surface->h);
+    const auto pitch = static_cast<size_t>(surface->pitch);
+    const auto *source = static_cast<const std::uint8_t *>(surface->pixels);
+    CapturedFrame frame = {next_index++, surface->w, surface->h, writer.Buffer(row_bytes * rows)};
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        std::memcpy(frame.pixels.data() + row * row_bytes, source + row * pitch, row_bytes);
+    }
+
+    SDL_DestroySurface(surface);
+    writer.Submit(std::move(frame));
+}
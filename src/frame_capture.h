@@ -0,0 +1,49 @@
+#pragma once
+
+#include "frame_writer.h"
+
+#include <SDL3/SDL.h>
+#include <array>
+#include <cstdint>
+
+// Renders frames into an offscreen target instead of the window and hands their pixels to a FrameWriter. Two targets
+// take turns: a frame is read back at the end of the next one, when the renderer has long finished drawing it, so
+// the readback does not wait for the frame in flight. Works with any renderer that supports render targets,
+// including the software one of headless runs.
+class FrameCapture
+{
+  private:
+    SDL_Renderer *renderer = nullptr;
+    FrameWriter &writer;
+    int width = 0;
+    int height = 0;
+    std::array<SDL_Texture *, 2> targets = {};
+    // the target drawn into, the other one holds the previous frame
+    size_t current = 0;
+    bool previous_pending = false;
+    SDL_Texture *window_target = nullptr;
+    std::uint64_t next_index = 0;
+
+  private:
+    void ReadBack(SDL_Texture *target);
+
+  public:
+    // throws std::runtime_error when the renderer cannot create the targets
+    FrameCapture(SDL_Renderer *renderer, int width, int height, FrameWriter &writer);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture(FrameCapture &&) = delete;
+    auto operator=(const FrameCapture &) -> FrameCapture & = delete;
+    auto operator=(FrameCapture &&) -> FrameCapture & = delete;
+
+    // everything drawn until EndFrame goes to the capture
+    void BeginFrame();
+    void EndFrame();
+    // reads back the last frame, call it before finishing the writer
+    void Flush();
+    // the frame that EndFrame completed, to show it in a window as well
+    [[nodiscard]] auto LastFrame() const -> SDL_Texture *;
+    [[nodiscard]] auto Width() const -> int;
+    [[nodiscard]] auto Height() const -> int;
+};
@@ -0,0 +1,90 @@
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+FrameStats::FrameStats(const CounterValues &start) : window_start(start)
+{
+}
+
+void FrameStats::AddFrame(const std::uint64_t frame_ns, const CounterValues &counters)
+{
+    auto &slot = samples[frames % FRAME_WINDOW];
+
+    if (frames >= FRAME_WINDOW)
+    {
+        // the evicted frame becomes the start of the window
+        window_start = slot.counters;
+    }
+
+    slot = {frame_ns, counters};
+    ++frames;
+}
+
+auto FrameStats::Count() const -> size_t
+{
+    return std::min(frames, FRAME_WINDOW);
+}
+
+auto FrameStats::WindowNanoseconds() const -> std::uint64_t
+{
+    std::uint64_t total = 0;
+
+    for (size_t i = 0; i < Count(); ++i)
+    {
+        total += samples[i].frame_ns;
+    }
+
+    return total;
+}
+
+auto FrameStats::CounterDelta(const Counter counter) const -> std::uint64_t
+{
+    if (frames == 0)
+    {
+        return 0;
+    }
+
+    const auto index = static_cast<size_t>(counter);
+    return samples[(frames - 1) % FRAME_WINDOW].counters[index] - window_start[index];
+}
+
+auto FrameStats::Fps() const -> double
+{
+    const auto total = WindowNanoseconds();
+    return total == 0 ? 0.0 : static_cast<double>(Count()) * 1e9 / static_cast<double>(total);
+}
+
+auto FrameStats::FrameTimePercentile(const double fraction) const -> double
+{
+    if (frames == 0)
+    {
+        return 0.0;
+    }
+
+    std::vector<std::uint64_t> times(Count());
+
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        times[i] = samples[i].frame_ns;
+    }
+
+    // nearest rank
+    const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(times.size())));
+    const auto nth = times.begin() + static_cast<std::ptrdiff_t>(std::clamp<size_t>(rank, 1, times.size()) - 1);
+    std::ranges::nth_element(times, nth);
+
+    return static_cast<double>(*nth) / 1e6;
+}
+
+auto FrameStats::PerFrame(const Counter counter) const -> double
+{
+    return frames == 0 ? 0.0 : static_cast<double>(CounterDelta(counter)) / static_cast<double>(Count());
+}
+
+auto FrameStats::PerSecond(const Counter counter) const -> double
+{
+    const auto total = WindowNanoseconds();
+    return total == 0 ? 0.0 : static_cast<double>(CounterDelta(counter)) * 1e9 / static_cast<double>(total);
+}
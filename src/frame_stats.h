@@ -0,0 +1,45 @@
+#pragma once
+
+#include "counters.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// frames kept for the statistics, about two seconds at 60 fps
+constexpr size_t FRAME_WINDOW = 128;
+
+// Rolling statistics of the last FRAME_WINDOW frames: frame times and how fast the counters moved.
+class FrameStats
+{
+  private:
+    struct Sample
+    {
+        std::uint64_t frame_ns;
+        CounterValues counters;
+    };
+
+    std::array<Sample, FRAME_WINDOW> samples = {};
+    // frames ever added, the next one goes to frames % FRAME_WINDOW
+    size_t frames = 0;
+    // counter values before the oldest frame of the window
+    CounterValues window_start = {};
+
+  private:
+    [[nodiscard]] auto Count() const -> size_t;
+    [[nodiscard]] auto WindowNanoseconds() const -> std::uint64_t;
+    [[nodiscard]] auto CounterDelta(Counter counter) const -> std::uint64_t;
+
+  public:
+    // `start` are the counter values before the first frame
+    explicit FrameStats(const CounterValues &start = {});
+
+    // `counters` are the counter values at the end of the frame
+    void AddFrame(std::uint64_t frame_ns, const CounterValues &counters);
+
+    [[nodiscard]] auto Fps() const -> double;
+    // frame time in milliseconds below which `fraction` of the frames of the window fall
+    [[nodiscard]] auto FrameTimePercentile(double fraction) const -> double;
+    [[nodiscard]] auto PerFrame(Counter counter) const -> double;
+    [[nodiscard]] auto PerSecond(Counter counter) const -> double;
+};
@@ -0,0 +1,160 @@
+#include "frame_writer.h"
+#include "png.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+auto DefaultCapturePath() -> std::filesystem::path
+{
+    return std::filesystem::path(USER_DATA_DIR) / "captures";
+}
+
+FrameWriter::FrameWriter(std::filesystem::path directory, const unsigned threads, const size_t max_pending)
+    : directory(std::move(directory)), max_pending(std::max<size_t>(max_pending, 1))
+{
+    std::error_code error_code;
+    std::filesystem::create_directories(this->directory, error_code);
+
+    if (error_code)
+    {
+        throw std::runtime_error("unable to create " + this->directory.string() + ": " + error_code.message());
+    }
+
+    for (unsigned i = 0; i < std::max(threads, 1U); ++i)
+    {
+        workers.emplace_back(&FrameWriter::WorkerLoop, this);
+    }
+}
+
+FrameWriter::~FrameWriter()
+{
+    {
+        const std::scoped_lock lock(mutex);
+        stopping = true;
+    }
+
+    pending_cv.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+auto FrameWriter::FramePath(const std::filesystem::path &directory, const std::uint64_t index) -> std::filesystem::path
+{
+    return directory / std::format("frame_{:06}.png", index);
+}
+
+auto FrameWriter::Buffer(const size_t bytes) -> std::vector<std::uint8_t>
+{
+    std::vector<std::uint8_t> buffer;
+
+    {
+        const std::scoped_lock lock(mutex);
+
+        if (!free_buffers.empty())
+        {
+            buffer = std::move(free_buffers.back());
+            free_buffers.pop_back();
+        }
+    }
+
+    buffer.resize(bytes);
+    return buffer;
+}
+
+void FrameWriter::Submit(CapturedFrame frame)
+{
+    TRACE_SCOPE("FrameWriter::Submit");
+
+    {
+        std::unique_lock lock(mutex);
+        // back pressure rather than dropped frames when the encoders fall behind
+        done_cv.wait(lock, [this] { return pending.size() < max_pending; });
+        pending.push_back(std::move(frame));
+    }
+
+    pending_cv.notify_one();
+}
+
+void FrameWriter::Finish()
+{
+    std::unique_lock lock(mutex);
+    done_cv.wait(lock, [this] { return pending.empty() && encoding == 0; });
+
+    if (!error.empty())
+    {
+        throw std::runtime_error(std::exchange(error, {}));
+    }
+}
+
+auto FrameWriter::Written() -> std::uint64_t
+{
+    const std::scoped_lock lock(mutex);
+    return written;
+}
+
+void FrameWriter::WorkerLoop()
+{
+    std::unique_lock lock(mutex);
+
+    while (true)
+    {
+        // the frames still pending are written before stopping
+        pending_cv.wait(lock, [this] { return stopping || !pending.empty(); });
+
+        if (pending.empty())
+        {
+            return;
+        }
+
+        CapturedFrame frame = std::move(pending.front());
+        pending.pop_front();
+        ++encoding;
+        done_cv.notify_all();
+
+        lock.unlock();
+
+        std::string failure;
+
+        try
+        {
+            TRACE_SCOPE("FrameWriter::Encode");
+
+            const auto path = FramePath(directory, frame.index);
+            const auto png = EncodePng(frame.pixels, frame.width, frame.height, static_cast<size_t>(frame.width) * 4);
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+
+            if (!out)
+            {
+                throw std::runtime_error("failed to write " + path.string());
+            }
+        }
+        catch (const std::exception &e)
+        {
+            failure = e.what();
+        }
+
+        lock.lock();
+        --encoding;
+
+        if (failure.empty())
+        {
+            ++written;
+        }
+        else if (error.empty())
+        {
+            // the first failure, the others are likely the same
+            error = std::move(failure);
+        }
+
+        free_buffers.push_back(std::move(frame.pixels));
+        done_cv.notify_all();
+    }
+}
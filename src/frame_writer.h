@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A frame read back from the renderer: tightly packed 8-bit RGBA rows.
+struct CapturedFrame
+{
+    std::uint64_t index = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> pixels;
+};
+
+// the directory of the in-game captures, one subdirectory per capture
+auto DefaultCapturePath() -> std::filesystem::path;
+
+// Encodes captured frames as frame_000000.png, frame_000001.png... on a pool of threads, so that the loop that
+// captures them only pays for the copy. No frame is ever dropped: when `max_pending` frames wait for a worker, Submit
+// waits too. Pixel buffers go back to the caller through Buffer once written, so a steady capture does not allocate.
+class FrameWriter
+{
+  private:
+    std::filesystem::path directory;
+    size_t max_pending;
+    std::mutex mutex;
+    std::condition_variable pending_cv;
+    std::condition_variable done_cv;
+    std::deque<CapturedFrame> pending;
+    std::vector<std::vector<std::uint8_t>> free_buffers;
+    size_t encoding = 0;
+    std::uint64_t written = 0;
+    std::string error;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+  private:
+    void WorkerLoop();
+
+  public:
+    // throws std::runtime_error when the directory cannot be created
+    FrameWriter(std::filesystem::path directory, unsigned threads, size_t max_pending);
+    // writes what is still pending before returning
+    ~FrameWriter();
+
+    FrameWriter(const FrameWriter &) = delete;
+    FrameWriter(FrameWriter &&) = delete;
+    auto operator=(const FrameWriter &) -> FrameWriter & = delete;
+    auto operator=(FrameWriter &&) -> FrameWriter & = delete;
+
+    [[nodiscard]] static auto FramePath(const std::filesystem::path &directory, std::uint64_t index)
+        -> std::filesystem::path;
+
+    // an empty buffer of `bytes` bytes, recycled from a written frame when there is one
+    auto Buffer(size_t bytes) -> std::vector<std::uint8_t>;
+    void Submit(CapturedFrame frame);
+    // waits until every submitted frame is written; throws std::runtime_error when one could not be
+    void Finish();
+    [[nodiscard]] auto Written() -> std::uint64_t;
+};
@@ -1,10 +1,34 @@
 #include "game.h"
+#include "trace.h"
 
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 
-Game::Game() : gen(std::random_device()())
+auto DirectionName(const Direction dir) -> std::string_view
+{
+    switch (dir)
+    {
+    case Direction::UP:
+        return "Up";
+    case Direction::DOWN:
+        return "Down";
+    case Direction::LEFT:
+        return "Left";
+    case Direction::RIGHT:
+    default:
+        return "Right";
+    }
+}
+
+Game::Game() : Game(std::random_device()())
+{
+}
+
+Game::Game(const std::uint32_t seed) : seed(seed), gen(seed)
 {
 }
 
@@ -18,9 +42,15 @@ auto Game::State() const -> GameState
     return state;
 }
 
+auto Game::Seed() const -> std::uint32_t
+{
+    return seed;
+}
+
 void Game::Start()
 {
     state = GameState::Playing;
+    moves = 0;
     grid.Init();
     Spawn();
     Spawn();
@@ -29,18 +59,30 @@ void Game::Start()
 void Game::Reset()
 {
     score = 0;
+    endless = false;
     Start();
 }
 
+void Game::Continue()
+{
+    if (state == GameState::Victory)
+    {
+        state = GameState::Playing;
+        endless = true;
+    }
+}
+
 void Game::Move(const Direction dir)
 {
-    int move_score = 0;
+    TRACE_SCOPE("Game::Move");
+
+    std::uint64_t move_score = 0;
 
     if (dir == Direction::UP or dir == Direction::DOWN)
     {
         for (size_t col = 0; col < grid.Cols(); ++col)
         {
-            move_score = MoveCol(col, dir);
+            move_score += MoveCol(col, dir);
         }
     }
     else
@@ -52,20 +94,73 @@ void Game::Move(const Direction dir)
     }
 
     score += move_score;
+    ++moves;
+}
+
+void Game::Play(const Grid &moved, const std::uint64_t move_score)
+{
+    grid = moved;
+    score += move_score;
+    ++moves;
+}
+
+void Game::Restore(const Grid &saved_grid, const std::uint64_t saved_score, const std::uint64_t saved_best,
+                   const GameState saved_state, const std::uint32_t saved_seed, const bool saved_endless,
+                   const std::string &saved_random)
+{
+    grid = saved_grid;
+    score = saved_score;
+    best_score = saved_best;
+    state = saved_state;
+    seed = saved_seed;
+    endless = saved_endless;
+    gen.seed(seed);
+
+    if (!saved_random.empty())
+    {
+        std::istringstream in(saved_random);
+
+        if (!(in >> gen))
+        {
+            throw std::invalid_argument("invalid random state");
+        }
+    }
 }
 
-auto Game::Score() const -> std::uint32_t
+auto Game::RandomState() const -> std::string
+{
+    std::ostringstream out;
+    out << gen;
+    return out.str();
+}
+
+auto Game::Score() const -> std::uint64_t
 {
     return score;
 }
 
-auto Game::BestScore() const -> std::uint32_t
+auto Game::BestScore() const -> std::uint64_t
 {
     return best_score;
 }
 
+auto Game::Moves() const -> std::uint64_t
+{
+    return moves;
+}
+
+auto Game::Endless() const -> bool
+{
+    return endless;
+}
+
 auto Game::CheckVictory() -> bool
 {
+    if (endless)
+    {
+        return false;
+    }
+
     for (size_t row = 0; row < grid.Rows(); ++row)
     {
         for (size_t col = 0; col < grid.Cols(); ++col)
@@ -95,13 +190,11 @@ auto Game::CheckGameOver() -> bool
                 return false;
             }
 
-            for (const Tile &neigh : grid.AdjacentTiles(row, col))
+            // there are still tiles that can be merged: looking right and down covers every pair of neighbours
+            if ((col + 1 < grid.Cols() && grid.GetTile(row, col + 1).value == tile.value) ||
+                (row + 1 < grid.Rows() && grid.GetTile(row + 1, col).value == tile.value))
             {
-                // there are still tiles that can be merged
-                if (tile.value == neigh.value)
-                {
-                    return false;
-                }
+                return false;
             }
         }
     }
@@ -121,11 +214,11 @@ auto Game::Update() -> bool
     return CheckGameOver() || CheckVictory();
 }
 
-auto Game::MoveRow(const size_t row, const Direction dir) -> uint8_t
+auto Game::MoveRow(const size_t row, const Direction dir) -> std::uint64_t
 {
     assert(dir == Direction::LEFT || dir == Direction::RIGHT);
 
-    uint8_t score = 0;
+    std::uint64_t score = 0;
 
     const bool is_right = dir == Direction::RIGHT;
     const size_t start_col = is_right ? grid.Cols() - 1 : 0;
@@ -173,11 +266,11 @@ auto Game::MoveRow(const size_t row, const Direction dir) -> uint8_t
 }
 
 // Bad Copy from MoveRow (Need Refactoring)
-auto Game::MoveCol(const size_t col, const Direction dir) -> uint8_t
+auto Game::MoveCol(const size_t col, const Direction dir) -> std::uint64_t
 {
     assert(dir == Direction::UP || dir == Direction::DOWN);
 
-    uint8_t score = 0;
+    std::uint64_t score = 0;
 
     const bool is_down = dir == Direction::DOWN;
     const size_t start_row = is_down ? grid.Rows() - 1 : 0;
@@ -226,27 +319,29 @@ auto Game::MoveCol(const size_t col, const Direction dir) -> uint8_t
 
 auto Game::Spawn() -> bool
 {
-    // get empty tiles
-    std::vector<std::pair<size_t, size_t>> empty_tiles;
-    empty_tiles.reserve(grid.Rows() * grid.Cols() - 1);
+    TRACE_SCOPE("Game::Spawn");
+
+    // get empty tiles, on the stack: a spawn follows every move of every playout
+    std::array<std::pair<size_t, size_t>, GRID_TILES> empty_tiles;
+    size_t n_empty = 0;
 
-    for (int row = 0; row < grid.Rows(); ++row)
+    for (size_t row = 0; row < grid.Rows(); ++row)
     {
-        for (int col = 0; col < grid.Cols(); ++col)
+        for (size_t col = 0; col < grid.Cols(); ++col)
         {
             if (grid.IsEmpty(row, col))
             {
-                empty_tiles.emplace_back(row, col);
+                empty_tiles.at(n_empty++) = {row, col};
             }
         }
     }
 
-    if (empty_tiles.empty())
+    if (n_empty == 0)
     {
         return false;
     }
 
-    std::uniform_int_distribution<size_t> index_dist(0, empty_tiles.size() - 1);
+    std::uniform_int_distribution<size_t> index_dist(0, n_empty - 1);
 
     // get random empty tile
     const size_t randomIdx = index_dist(gen);
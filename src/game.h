@@ -3,10 +3,14 @@
 #include "grid.h"
 
 #include <random>
+#include <string>
+#include <string_view>
 
 constexpr double PROB_2 = 0.9;
 constexpr double PROB_4 = 0.1;
 constexpr int WIN_TILE = 2048;
+// largest tile a 4x4 board can reach, spawning 4s into the last free cell
+constexpr std::uint32_t MAX_TILE = 1U << 17;
 
 enum class Direction : std::int8_t
 {
@@ -16,6 +20,8 @@ enum class Direction : std::int8_t
     RIGHT
 };
 
+auto DirectionName(Direction dir) -> std::string_view;
+
 enum class GameState : uint8_t
 {
     Startup,
@@ -28,26 +34,44 @@ struct Game
 {
   private:
     Grid grid;
-    std::uint32_t score = 0;
-    std::uint32_t best_score = 0;
+    std::uint64_t score = 0;
+    std::uint64_t best_score = 0;
+    // moves played since the game started
+    std::uint64_t moves = 0;
     GameState state = GameState::Startup;
+    // the game goes on after the win tile, until the board is full
+    bool endless = false;
+    std::uint32_t seed;
     std::mt19937 gen;
 
   private:
     auto Spawn() -> bool;
     auto CheckVictory() -> bool;
     auto CheckGameOver() -> bool;
-    auto MoveRow(size_t row, Direction dir) -> uint8_t;
-    auto MoveCol(size_t col, Direction dir) -> uint8_t;
+    auto MoveRow(size_t row, Direction dir) -> std::uint64_t;
+    auto MoveCol(size_t col, Direction dir) -> std::uint64_t;
 
   public:
     Game();
+    explicit Game(std::uint32_t seed);
     auto GetGrid() -> Grid &;
     void Start();
     void Reset();
     void Move(Direction dir);
+    // counts a move computed outside the grid, e.g. on a packed board: `moved` is the grid after it
+    void Play(const Grid &moved, std::uint64_t move_score);
+    // keeps playing after a victory, the win tile is not checked again
+    void Continue();
+    // `saved_random` is a RandomState() to carry on the spawns from, empty restarts them from the seed
+    void Restore(const Grid &saved_grid, std::uint64_t saved_score, std::uint64_t saved_best, GameState saved_state,
+                 std::uint32_t saved_seed, bool saved_endless, const std::string &saved_random = {});
     auto Update() -> bool;
-    [[nodiscard]] auto Score() const -> std::uint32_t;
-    [[nodiscard]] auto BestScore() const -> std::uint32_t;
+    [[nodiscard]] auto Score() const -> std::uint64_t;
+    [[nodiscard]] auto BestScore() const -> std::uint64_t;
+    [[nodiscard]] auto Moves() const -> std::uint64_t;
+    [[nodiscard]] auto Endless() const -> bool;
     [[nodiscard]] auto State() const -> GameState;
+    [[nodiscard]] auto Seed() const -> std::uint32_t;
+    // the position of the spawns in the seed's sequence, as the text of the engine state
+    [[nodiscard]] auto RandomState() const -> std::string;
 };
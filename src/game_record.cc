@@ -0,0 +1,154 @@
+#include "game_record.h"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+constexpr std::array<char, 8> GAME_RECORD_MAGIC = {'C', '2', '0', '4', '8', 'G', 'R', '\0'};
+constexpr std::uint32_t GAME_RECORD_VERSION = 1;
+
+// start board and move count in front of the moves of every record
+constexpr size_t RECORD_PREFIX = sizeof(Board) + sizeof(std::uint32_t);
+
+constexpr std::uint8_t STEP_FOUR = 0x40;
+
+void GameRecord::Add(const Direction dir, const Board after, const Board next)
+{
+    // the spawn is the only cell that differs
+    const Board spawned = after ^ next;
+    const auto cell = static_cast<std::uint8_t>(std::countr_zero(spawned) / 4);
+    const bool four = GetCell(next, cell) == 2;
+
+    steps.push_back(static_cast<std::uint8_t>(static_cast<std::uint8_t>(dir) | cell << 2 | (four ? STEP_FOUR : 0)));
+}
+
+GameRecordWriter::GameRecordWriter(const std::filesystem::path &path)
+    : path(path), out(path, std::ios::binary | std::ios::trunc)
+{
+    GameRecordFileHeader header = {};
+    header.magic = GAME_RECORD_MAGIC;
+    header.version = GAME_RECORD_VERSION;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if (!out)
+    {
+        throw std::runtime_error("failed to write " + path.string());
+    }
+}
+
+void GameRecordWriter::Write(const GameRecord &record)
+{
+    const auto moves = static_cast<std::uint32_t>(record.steps.size());
+
+    out.write(reinterpret_cast<const char *>(&record.start), sizeof(record.start));
+    out.write(reinterpret_cast<const char *>(&moves), sizeof(moves));
+    out.write(reinterpret_cast<const char *>(record.steps.data()), static_cast<std::streamsize>(moves));
+}
+
+void GameRecordWriter::Flush()
+{
+    out.flush();
+
+    if (!out)
+    {
+        throw std::runtime_error("failed to write " + path.string());
+    }
+}
+
+GameRecordReader::GameRecordReader(const std::span<const std::byte> bytes) : bytes(bytes)
+{
+    GameRecordFileHeader header = {};
+
+    if (bytes.size() < sizeof(header))
+    {
+        throw std::runtime_error("not a game record file");
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != GAME_RECORD_MAGIC || header.version != GAME_RECORD_VERSION)
+    {
+        throw std::runtime_error("not a game record file");
+    }
+}
+
+auto GameRecordReader::Next(GameRecordView &record) -> bool
+{
+    if (offset == bytes.size())
+    {
+        return false;
+    }
+
+    std::uint32_t moves = 0;
+
+    if (bytes.size() - offset < RECORD_PREFIX)
+    {
+        throw std::runtime_error("game record is truncated");
+    }
+
+    std::memcpy(&record.start, bytes.data() + offset, sizeof(record.start));
+    std::memcpy(&moves, bytes.data() + offset + sizeof(record.start), sizeof(moves));
+
+    if (bytes.size() - offset - RECORD_PREFIX < moves)
+    {
+        throw std::runtime_error("game record is truncated");
+    }
+
+    record.steps = {reinterpret_cast<const std::uint8_t *>(bytes.data() + offset + RECORD_PREFIX), moves};
+    offset += RECORD_PREFIX + moves;
+    return true;
+}
+
+auto GameRecordReader::Offset() const -> size_t
+{
+    return offset;
+}
+
+void GameRecordReader::Seek(const size_t record_offset)
+{
+    if (record_offset < sizeof(GameRecordFileHeader) || record_offset > bytes.size())
+    {
+        throw std::out_of_range("record offset is outside of the file");
+    }
+
+    offset = record_offset;
+}
+
+auto ApplyStep(const Board board, const std::uint8_t step) -> std::optional<MoveResult>
+{
+    const auto dir = static_cast<Direction>(step & 0x3);
+    const auto cell = static_cast<size_t>((step >> 2) & 0xf);
+    const auto [after, score] = MoveBoard(board, dir);
+
+    if (after == board || GetCell(after, cell) != 0)
+    {
+        return std::nullopt;
+    }
+
+    return MoveResult{SetCell(after, cell, (step & STEP_FOUR) != 0 ? 2 : 1), score};
+}
+
+auto ReplayRecord(const GameRecordView &record) -> ReplayResult
+{
+    ReplayResult result;
+    Board board = record.start;
+
+    for (const auto step : record.steps)
+    {
+        const auto next = ApplyStep(board, step);
+
+        if (!next)
+        {
+            result.valid = false;
+            break;
+        }
+
+        board = next->board;
+        result.score += next->score;
+        ++result.moves;
+        ++result.directions.at(static_cast<size_t>(step & 0x3));
+    }
+
+    result.max_exponent = MaxExponent(board);
+    return result;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "board.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <vector>
+
+// A played game as its first board and one byte per move: the direction in bits 0-1, the cell of the spawned tile
+// in bits 2-5 and whether it was a 4 in bit 6. The spawns are recorded instead of a seed, so that games of any
+// random generator replay the same way.
+struct GameRecord
+{
+    Board start = 0;
+    std::vector<std::uint8_t> steps;
+
+    // `after` is the board after the move, `next` the board after the spawn
+    void Add(Direction dir, Board after, Board next);
+};
+
+struct GameRecordView
+{
+    Board start = 0;
+    std::span<const std::uint8_t> steps;
+};
+
+struct GameRecordFileHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+// Record files are the header followed by the records: the start board, the number of moves as 32 bits and the
+// moves, in the byte order of the host like the other files of the solver.
+class GameRecordWriter
+{
+  private:
+    std::filesystem::path path;
+    std::ofstream out;
+
+  public:
+    explicit GameRecordWriter(const std::filesystem::path &path);
+
+    void Write(const GameRecord &record);
+    // throws std::runtime_error when anything failed to be written
+    void Flush();
+};
+
+// Walks the records of a (memory-mapped) file without copying them. Throws std::runtime_error on a file that is
+// not a record file or a record that is cut short.
+class GameRecordReader
+{
+  private:
+    std::span<const std::byte> bytes;
+    size_t offset = sizeof(GameRecordFileHeader);
+
+  public:
+    explicit GameRecordReader(std::span<const std::byte> bytes);
+
+    // false at the end of the file
+    auto Next(GameRecordView &record) -> bool;
+    // offset of the next record, so that a file can be split into ranges
+    [[nodiscard]] auto Offset() const -> size_t;
+    void Seek(size_t record_offset);
+};
+
+struct ReplayResult
+{
+    std::uint64_t score = 0;
+    std::uint32_t moves = 0;
+    std::uint8_t max_exponent = 0;
+    std::array<std::uint32_t, 4> directions = {};
+    // false when a move changed nothing or a spawn landed on a tile
+    bool valid = true;
+};
+
+// The board after one recorded step and the score of its move, none when the step does not apply to `board`.
+auto ApplyStep(Board board, std::uint8_t step) -> std::optional<MoveResult>;
+
+// Plays the record again through the rules of MoveBoard.
+auto ReplayRecord(const GameRecordView &record) -> ReplayResult;
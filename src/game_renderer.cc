@@ -1,46 +1,134 @@
 #include "game_renderer.h"
+#include "counters.h"
 #include "layout.h"
+#include "trace.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
 #include <cmath>
+#include <format>
 
 GameRenderer::GameRenderer(SDL_Renderer *renderer, TTF_Font *font) : renderer(renderer), font(font)
 {
 }
 
+GameRenderer::~GameRenderer()
+{
+    ClearTextCache();
+    InvalidateTileAtlas();
+}
+
+auto GameRenderer::RasterizeText(const TextBox &text_box, const float width, const float height) const -> CachedText
+{
+    TTF_SetFontSize(font, text_box.size);
+    SDL_Surface *surface = TTF_RenderText_Blended(font, text_box.text.c_str(), 0, text_box.color);
+    CountEvent(Counter::TextRasterizations);
+
+    if (surface && text_box.fit_container)
+    {
+        const auto font_size = AdjustFontSizeToFitRect(surface, font, text_box.text, text_box.size, height, width);
+
+        TTF_SetFontSize(font, font_size);
+        surface = TTF_RenderText_Blended(font, text_box.text.c_str(), 0, text_box.color);
+        CountEvent(Counter::TextRasterizations);
+    }
+
+    // empty strings have no surface
+    if (!surface)
+    {
+        return {nullptr, 0, 0, frame};
+    }
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    CountEvent(Counter::TextureCreations);
+
+    const CachedText text = {texture, static_cast<float>(surface->w), static_cast<float>(surface->h), frame};
+    SDL_DestroySurface(surface);
+    return text;
+}
+
 void GameRenderer::DrawText(const TextBox &text_box, const SDL_FRect &rect) const
 {
+    TRACE_SCOPE("GameRenderer::DrawText");
+
     auto [x, y, w, h] = rect;
     x = rect.x + text_box.padding_x;
     y = rect.y + text_box.padding_y;
     w = rect.w - 2 * text_box.padding_x;
     h = rect.h - 2 * text_box.padding_y;
 
-    TTF_SetFontSize(font, text_box.size);
-    SDL_Surface *surface = TTF_RenderText_Blended(font, text_box.text.c_str(), 0, text_box.color);
+    // the box only changes the rasterized size when the text is fitted into it
+    const auto &[r, g, b, a] = text_box.color;
+    const auto key = std::format("{}|{}|{},{},{},{}|{}x{}", text_box.text, text_box.size, r, g, b, a,
+                                 text_box.fit_container ? w : 0, text_box.fit_container ? h : 0);
 
-    if (text_box.fit_container)
-    {
-        const auto font_size = AdjustFontSizeToFitRect(surface, font, text_box.text, text_box.size, h, w);
+    auto found = text_cache.find(key);
 
-        TTF_SetFontSize(font, font_size);
-        surface = TTF_RenderText_Blended(font, text_box.text.c_str(), 0, text_box.color);
+    if (found == text_cache.end())
+    {
+        found = text_cache.emplace(key, RasterizeText(text_box, w, h)).first;
     }
 
-    const auto text_width = static_cast<float>(surface->w);
-    const auto text_height = static_cast<float>(surface->h);
+    auto &text = found->second;
+    text.last_frame = frame;
+
+    if (!text.texture)
+    {
+        return;
+    }
 
     SDL_FRect text_rect = {x, y, w, h};
-    AlignTextRect(text_rect, text_height, text_width, text_box.alignment);
+    AlignTextRect(text_rect, text.height, text.width, text_box.alignment);
+    SDL_RenderTexture(renderer, text.texture, nullptr, &text_rect);
+}
 
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_RenderTexture(renderer, texture, nullptr, &text_rect);
+void GameRenderer::EndFrame()
+{
+    ++frame;
 
-    SDL_DestroySurface(surface);
-    SDL_DestroyTexture(texture);
+    // text that is no longer drawn, e.g. old scores or the sizes of a previous layout
+    std::erase_if(text_cache, [this](const auto &entry) {
+        const auto &text = entry.second;
+
+        if (text.last_frame + TEXT_CACHE_FRAMES >= frame)
+        {
+            return false;
+        }
+
+        if (text.texture)
+        {
+            SDL_DestroyTexture(text.texture);
+        }
+
+        return true;
+    });
+}
+
+void GameRenderer::ClearTextCache()
+{
+    for (const auto &[_key, text] : text_cache)
+    {
+        if (text.texture)
+        {
+            SDL_DestroyTexture(text.texture);
+        }
+    }
+
+    text_cache.clear();
+
+    if (digit_atlas)
+    {
+        SDL_DestroyTexture(digit_atlas);
+        digit_atlas = nullptr;
+    }
 }
 
 void GameRenderer::DrawScoreBox(const ScoreBox &box, const SDL_FRect &rect) const
 {
+    TRACE_SCOPE("GameRenderer::DrawScoreBox");
+
     FillRect(renderer, &rect, box.bg_color);
     DrawText(box.label_text, rect);
     DrawText(box.score_text, rect);
@@ -48,8 +136,9 @@ void GameRenderer::DrawScoreBox(const ScoreBox &box, const SDL_FRect &rect) cons
 
 void GameRenderer::DrawTile(const Tile &tile, const TileLayout &layout) const
 {
-    const auto idx = static_cast<size_t>(tile.value == 0 ? 0 : std::log2(tile.value));
-    const auto &[background, foreground] = tile_colors.at(idx);
+    TRACE_SCOPE("GameRenderer::DrawTile");
+
+    const auto [background, foreground] = TileStyleFor(tile.value);
 
     // tile background
     FillRect(renderer, &layout.rect, background);
@@ -63,23 +152,304 @@ void GameRenderer::DrawTile(const Tile &tile, const TileLayout &layout) const
     }
 }
 
-void GameRenderer::DrawGrid(const Grid &grid, const GridLayout &layout) const
+void GameRenderer::BuildTileAtlas(const TileLayout &layout)
+{
+    TRACE_SCOPE("GameRenderer::BuildTileAtlas");
+
+    InvalidateTileAtlas();
+
+    // one cell per style, a gap between them so that filtering never bleeds a neighbour in
+    constexpr size_t rows = (ATLAS_STYLES + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    const auto cell_width = std::ceil(layout.rect.w) + ATLAS_GAP;
+    const auto cell_height = std::ceil(layout.rect.h) + ATLAS_GAP;
+    const auto width = static_cast<int>(cell_width) * static_cast<int>(ATLAS_COLUMNS);
+    const auto height = static_cast<int>(cell_height) * static_cast<int>(rows);
+
+    tile_atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+
+    if (!tile_atlas)
+    {
+        return;
+    }
+
+    CountEvent(Counter::TextureCreations);
+    SDL_SetTextureBlendMode(tile_atlas, SDL_BLENDMODE_BLEND);
+
+    SDL_Texture *previous_target = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, tile_atlas);
+    SetRenderColor(renderer, {0, 0, 0, 0});
+    SDL_RenderClear(renderer);
+
+    // copy the backgrounds as they are: blending the translucent empty tile into the cleared atlas would darken it
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    for (size_t exponent = 0; exponent < ATLAS_STYLES; ++exponent)
+    {
+        auto cell = layout;
+        cell.rect = SDL_FRect(static_cast<float>(exponent % ATLAS_COLUMNS) * cell_width,
+                              static_cast<float>(exponent / ATLAS_COLUMNS) * cell_height, layout.rect.w, layout.rect.h);
+
+        const auto value = exponent == 0 ? 0 : std::uint32_t{1} << exponent;
+        DrawTile(Tile{0, 0, value}, cell);
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(renderer, previous_target);
+
+    atlas_tile_width = layout.rect.w;
+    atlas_tile_height = layout.rect.h;
+    atlas_cell_width = cell_width;
+    atlas_cell_height = cell_height;
+    atlas_width = static_cast<float>(width);
+    atlas_height = static_cast<float>(height);
+}
+
+auto GameRenderer::PrepareTileAtlas(const TileLayout &layout) -> bool
+{
+    // every tile has the same size, a new size means a new layout
+    if (!tile_atlas || layout.rect.w != atlas_tile_width || layout.rect.h != atlas_tile_height)
+    {
+        BuildTileAtlas(layout);
+    }
+
+    return tile_atlas != nullptr;
+}
+
+auto GameRenderer::TileTexCoords(const size_t exponent) const -> SDL_FRect
 {
+    const float cell_x = static_cast<float>(exponent % ATLAS_COLUMNS) * atlas_cell_width;
+    const float cell_y = static_cast<float>(exponent / ATLAS_COLUMNS) * atlas_cell_height;
+
+    return {cell_x / atlas_width, cell_y / atlas_height, atlas_tile_width / atlas_width,
+            atlas_tile_height / atlas_height};
+}
+
+void GameRenderer::BuildDigitAtlas(const float font_size)
+{
+    TRACE_SCOPE("GameRenderer::BuildDigitAtlas");
+
+    if (digit_atlas)
+    {
+        SDL_DestroyTexture(digit_atlas);
+        digit_atlas = nullptr;
+    }
+
+    // white, so that the vertex colour alone decides the colour of a score
+    constexpr SDL_Color white = {0xff, 0xff, 0xff, 0xff};
+    std::array<SDL_Surface *, DIGITS> glyphs = {};
+    int cell_width = 0;
+    int height = 0;
+    bool complete = true;
+
+    TTF_SetFontSize(font, font_size);
+
+    for (size_t digit = 0; digit < DIGITS; ++digit)
+    {
+        const char glyph = static_cast<char>('0' + digit);
+        glyphs[digit] = TTF_RenderText_Blended(font, &glyph, 1, white);
+        CountEvent(Counter::TextRasterizations);
+
+        if (!glyphs[digit])
+        {
+            complete = false;
+            break;
+        }
+
+        cell_width = std::max(cell_width, glyphs[digit]->w);
+        height = std::max(height, glyphs[digit]->h);
+    }
+
+    SDL_Surface *sheet =
+        complete ? SDL_CreateSurface(cell_width * static_cast<int>(DIGITS), height, SDL_PIXELFORMAT_RGBA32) : nullptr;
+
+    for (size_t digit = 0; digit < DIGITS && glyphs[digit]; ++digit)
+    {
+        if (sheet)
+        {
+            // copied as they are, the sheet starts transparent
+            SDL_Rect cell = {static_cast<int>(digit) * cell_width, 0, glyphs[digit]->w, glyphs[digit]->h};
+            SDL_SetSurfaceBlendMode(glyphs[digit], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphs[digit], nullptr, sheet, &cell);
+            digit_widths[digit] = static_cast<float>(glyphs[digit]->w);
+        }
+
+        SDL_DestroySurface(glyphs[digit]);
+    }
+
+    if (!sheet)
+    {
+        return;
+    }
+
+    digit_atlas = SDL_CreateTextureFromSurface(renderer, sheet);
+    CountEvent(Counter::TextureCreations);
+    SDL_DestroySurface(sheet);
+
+    digit_font_size = font_size;
+    digit_cell_width = static_cast<float>(cell_width);
+    digit_height = static_cast<float>(height);
+}
+
+void GameRenderer::AddQuad(const SDL_FRect &rect, const SDL_FColor &color, const SDL_FRect &tex_coords)
+{
+    const auto first = static_cast<int>(batch_vertices.size());
+    const auto &[x, y, w, h] = rect;
+    const auto &[u, v, du, dv] = tex_coords;
+
+    batch_vertices.push_back({{x, y}, color, {u, v}});
+    batch_vertices.push_back({{x + w, y}, color, {u + du, v}});
+    batch_vertices.push_back({{x + w, y + h}, color, {u + du, v + dv}});
+    batch_vertices.push_back({{x, y + h}, color, {u, v + dv}});
+
+    // two triangles per quad
+    for (const int corner : {0, 1, 2, 0, 2, 3})
+    {
+        batch_indices.push_back(first + corner);
+    }
+}
+
+void GameRenderer::FlushQuads(SDL_Texture *texture)
+{
+    if (!batch_indices.empty())
+    {
+        SDL_RenderGeometry(renderer, texture, batch_vertices.data(), static_cast<int>(batch_vertices.size()),
+                           batch_indices.data(), static_cast<int>(batch_indices.size()));
+    }
+
+    batch_vertices.clear();
+    batch_indices.clear();
+}
+
+void GameRenderer::InvalidateTileAtlas()
+{
+    if (tile_atlas)
+    {
+        SDL_DestroyTexture(tile_atlas);
+        tile_atlas = nullptr;
+    }
+}
+
+void GameRenderer::DrawGrid(const Grid &grid, const GridLayout &layout)
+{
+    TRACE_SCOPE("GameRenderer::DrawGrid");
+
     // grid background
     FillRect(renderer, &layout.rect, layout.fg_color);
 
+    const bool atlas = PrepareTileAtlas(layout.GetTileLayout(0, 0));
+
+    // all the tiles in one textured draw call
     for (int row = 0; row < grid.Rows(); ++row)
     {
         for (int col = 0; col < grid.Cols(); ++col)
         {
             const Tile &tile = grid.GetTile(row, col);
-            DrawTile(tile, layout.GetTileLayout(row, col));
+            const auto &tile_layout = layout.GetTileLayout(row, col);
+            const auto exponent = static_cast<size_t>(tile.value == 0 ? 0 : std::bit_width(tile.value) - 1);
+
+            // no atlas (render targets unsupported) or a style the atlas does not have
+            if (!atlas || exponent >= ATLAS_STYLES)
+            {
+                DrawTile(tile, tile_layout);
+                continue;
+            }
+
+            AddQuad(tile_layout.rect, {1, 1, 1, 1}, TileTexCoords(exponent));
+        }
+    }
+
+    FlushQuads(tile_atlas);
+}
+
+void GameRenderer::DrawBoards(const std::span<const Board> boards, const std::span<const std::uint32_t> scores,
+                              const SpectatorLayout &layout)
+{
+    TRACE_SCOPE("GameRenderer::DrawBoards");
+
+    const auto count = std::min({boards.size(), scores.size(), layout.grids.size()});
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    // grid backgrounds, untextured
+    for (size_t i = 0; i < count; ++i)
+    {
+        AddQuad(layout.grids[i].rect, ToFColor(layout.grids[i].fg_color), {0, 0, 0, 0});
+    }
+
+    FlushQuads(nullptr);
+
+    // the exponents of a packed board never go past the atlas
+    const bool atlas = PrepareTileAtlas(layout.grids.front().GetTileLayout(0, 0));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t cell = 0; cell < BOARD_CELLS; ++cell)
+        {
+            const auto exponent = GetCell(boards[i], cell);
+            const auto &tile_layout = layout.grids[i].tiles[cell];
+
+            if (!atlas)
+            {
+                DrawTile(Tile{0, 0, exponent == 0 ? 0 : ExponentToValue(exponent)}, tile_layout);
+                continue;
+            }
+
+            AddQuad(tile_layout.rect, {1, 1, 1, 1}, TileTexCoords(exponent));
+        }
+    }
+
+    FlushQuads(tile_atlas);
+
+    // scores, centered under their grid
+    if (!digit_atlas || digit_font_size != layout.label_font_size)
+    {
+        BuildDigitAtlas(layout.label_font_size);
+    }
+
+    if (!digit_atlas)
+    {
+        return;
+    }
+
+    const auto color = ToFColor(layout.label_color);
+    const auto sheet_width = digit_cell_width * static_cast<float>(DIGITS);
+    std::array<char, 16> digits = {};
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto end = std::to_chars(digits.data(), digits.data() + digits.size(), scores[i]).ptr;
+        const auto &label = layout.labels[i];
+        float width = 0;
+
+        for (const char *digit = digits.data(); digit != end; ++digit)
+        {
+            width += digit_widths[static_cast<size_t>(*digit - '0')];
+        }
+
+        float x = label.x + (label.w - width) / 2;
+        const float y = label.y + (label.h - digit_height) / 2;
+
+        for (const char *digit = digits.data(); digit != end; ++digit)
+        {
+            const auto index = static_cast<size_t>(*digit - '0');
+            const auto u = static_cast<float>(index) * digit_cell_width / sheet_width;
+
+            AddQuad({x, y, digit_widths[index], digit_height}, color, {u, 0, digit_widths[index] / sheet_width, 1});
+            x += digit_widths[index];
         }
     }
+
+    FlushQuads(digit_atlas);
 }
 
-void GameRenderer::DrawScoreBoard(const uint32_t score, const uint32_t best, const ScoreBoardLayout &layout) const
+void GameRenderer::DrawScoreBoard(const std::uint64_t score, const std::uint64_t best,
+                                  const ScoreBoardLayout &layout) const
 {
+    TRACE_SCOPE("GameRenderer::DrawScoreBoard");
+
     auto score_label = TextBox("Score", layout.label_font_size, layout.label_padding_x, layout.label_padding_y,
                                layout.score_fg_color, TextAlignment::Left, true);
     auto score_value = TextBox(std::to_string(score), layout.value_font_size, layout.value_padding_x,
@@ -99,11 +469,15 @@ void GameRenderer::DrawScoreBoard(const uint32_t score, const uint32_t best, con
 
 void GameRenderer::DrawBackground(const SDL_Color &color) const
 {
+    TRACE_SCOPE("GameRenderer::DrawBackground");
+
     FillRect(renderer, nullptr, color);
 }
 
 void GameRenderer::DrawInitScreen(const MessageLayout &layout) const
 {
+    TRACE_SCOPE("GameRenderer::DrawInitScreen");
+
     FillRect(renderer, &layout.rect, layout.bg_color);
 
     constexpr std::string_view title = "Press any key to start";
@@ -120,6 +494,8 @@ void GameRenderer::DrawInitScreen(const MessageLayout &layout) const
 
 void GameRenderer::DrawEndGameMessage(const MessageLayout &layout, const GameState &state) const
 {
+    TRACE_SCOPE("GameRenderer::DrawEndGameMessage");
+
     FillRect(renderer, &layout.rect, layout.bg_color);
 
     std::string_view title;
@@ -133,7 +509,7 @@ void GameRenderer::DrawEndGameMessage(const MessageLayout &layout, const GameSta
     else
     {
         title = "Congratulations!";
-        subtitle = "Press 'R' to play again";
+        subtitle = "Press 'C' to continue or 'R' to restart";
     }
 
     const auto title_box = TextBox(title, layout.title_font_size, layout.end_title_padding_x, layout.padding_y,
@@ -144,3 +520,45 @@ void GameRenderer::DrawEndGameMessage(const MessageLayout &layout, const GameSta
     DrawText(title_box, layout.TitleRect());
     DrawText(subtitle_box, layout.SubtitleRect());
 }
+
+void GameRenderer::DrawHint(const std::string_view hint, const ScoreBoardLayout &layout) const
+{
+    TRACE_SCOPE("GameRenderer::DrawHint");
+
+    const auto hint_box =
+        TextBox(hint, layout.hint_font_size, 0, 0, layout.score_fg_color, TextAlignment::Center, true);
+    DrawText(hint_box, layout.HintRect());
+}
+
+void GameRenderer::DrawOverlay(const FrameStats &stats, const OverlayLayout &layout)
+{
+    TRACE_SCOPE("GameRenderer::DrawOverlay");
+
+    FillRect(renderer, &layout.rect, layout.bg_color);
+
+    // between refreshes the lines come from the text cache; the few rasterizations of a refresh still count, spread
+    // over the frames it lasts
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (overlay_refreshed_ns == 0 || now - overlay_refreshed_ns >= OVERLAY_REFRESH_NS)
+    {
+        overlay_refreshed_ns = now;
+        overlay_lines = {
+            std::format("{:.1f} fps", stats.Fps()),
+            std::format("frame p50 {:.2f} ms  p99 {:.2f} ms", stats.FrameTimePercentile(0.5),
+                        stats.FrameTimePercentile(0.99)),
+            std::format("{:.1f} {} / frame", stats.PerFrame(Counter::TextRasterizations),
+                        CounterName(Counter::TextRasterizations)),
+            std::format("{:.1f} {} / frame", stats.PerFrame(Counter::TextureCreations),
+                        CounterName(Counter::TextureCreations)),
+            std::format("{:.0f} {} / s", stats.PerSecond(Counter::SearchNodes), CounterName(Counter::SearchNodes)),
+        };
+    }
+
+    for (size_t line = 0; line < overlay_lines.size(); ++line)
+    {
+        const auto text =
+            TextBox(overlay_lines[line], layout.font_size, 0, 0, layout.fg_color, TextAlignment::Left, false);
+        DrawText(text, layout.LineRect(line));
+    }
+}
@@ -1,12 +1,20 @@
 #pragma once
 
+#include "board.h"
+#include "frame_stats.h"
 #include "game.h"
 #include "layout.h"
 #include "utils.h"
 
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct TextBox
 {
@@ -37,19 +45,91 @@ struct ScoreBox
 class GameRenderer
 {
   private:
+    struct CachedText
+    {
+        SDL_Texture *texture;
+        float width;
+        float height;
+        std::uint64_t last_frame;
+    };
+
+    // gap between the cells of the tile atlas, in pixels
+    static constexpr float ATLAS_GAP = 2;
+    // one cell per exponent up to MAX_TILE, in rows so that the atlas stays narrow on large outputs
+    static constexpr size_t ATLAS_STYLES = std::bit_width(MAX_TILE);
+    static constexpr size_t ATLAS_COLUMNS = 6;
+    // frames an unused text texture is kept for
+    static constexpr std::uint64_t TEXT_CACHE_FRAMES = 120;
+    static constexpr size_t DIGITS = 10;
+    static constexpr size_t OVERLAY_LINES = 5;
+    // the overlay text changes 4 times a second, so that its own rasterizations do not swamp the counters it shows
+    static constexpr Uint64 OVERLAY_REFRESH_NS = 250'000'000;
+
     SDL_Renderer *renderer = nullptr;
     TTF_Font *font = nullptr;
+    // every tile style pre-rendered at the current tile size, one cell per exponent
+    SDL_Texture *tile_atlas = nullptr;
+    float atlas_tile_width = 0;
+    float atlas_tile_height = 0;
+    float atlas_cell_width = 0;
+    float atlas_cell_height = 0;
+    float atlas_width = 0;
+    float atlas_height = 0;
+    // the ten digits in white at one font size, side by side: every score of the spectator view is made of them, tinted
+    // by the vertex colour
+    SDL_Texture *digit_atlas = nullptr;
+    float digit_font_size = 0;
+    float digit_cell_width = 0;
+    float digit_height = 0;
+    std::array<float, DIGITS> digit_widths = {};
+    // quads of the batched draws, kept between frames so that drawing does not allocate
+    std::vector<SDL_Vertex> batch_vertices;
+    std::vector<int> batch_indices;
+    // rasterized text by content, size, colour and fitting box; filled while drawing, hence mutable
+    mutable std::unordered_map<std::string, CachedText> text_cache;
+    std::uint64_t frame = 0;
+    std::array<std::string, OVERLAY_LINES> overlay_lines;
+    Uint64 overlay_refreshed_ns = 0;
 
   private:
+    [[nodiscard]] auto RasterizeText(const TextBox &text_box, float width, float height) const -> CachedText;
+    void BuildTileAtlas(const TileLayout &layout);
+    // builds the atlas for the size of `layout` when it has another one, false without render targets
+    auto PrepareTileAtlas(const TileLayout &layout) -> bool;
+    void BuildDigitAtlas(float font_size);
+    // texture coordinates of a tile style in the atlas
+    [[nodiscard]] auto TileTexCoords(size_t exponent) const -> SDL_FRect;
+    void AddQuad(const SDL_FRect &rect, const SDL_FColor &color, const SDL_FRect &tex_coords);
+    // draws the queued quads in one call, all from `texture`
+    void FlushQuads(SDL_Texture *texture);
     void DrawTile(const Tile &tile, const TileLayout &layout) const;
     void DrawText(const TextBox &text_box, const SDL_FRect &rect) const;
     void DrawScoreBox(const ScoreBox &box, const SDL_FRect &rect) const;
 
   public:
     GameRenderer(SDL_Renderer *renderer, TTF_Font *font);
+    ~GameRenderer();
+
+    GameRenderer(const GameRenderer &) = delete;
+    GameRenderer(GameRenderer &&) = delete;
+    auto operator=(const GameRenderer &) -> GameRenderer & = delete;
+    auto operator=(GameRenderer &&) -> GameRenderer & = delete;
+
+    // the atlas is rebuilt on the next DrawGrid, e.g. after the render targets were lost
+    void InvalidateTileAtlas();
+    // drops the text textures and the digit atlas, e.g. after the render device was lost
+    void ClearTextCache();
+    // evicts the text that was not drawn for a while
+    void EndFrame();
     void DrawBackground(const SDL_Color &color) const;
-    void DrawGrid(const Grid &grid, const GridLayout &layout) const;
-    void DrawScoreBoard(uint32_t score, uint32_t best, const ScoreBoardLayout &layout) const;
+    void DrawGrid(const Grid &grid, const GridLayout &layout);
+    // Every game of the spectator view in three draw calls whatever their number: grid backgrounds, tiles from the
+    // atlas and scores from the digit atlas.
+    void DrawBoards(std::span<const Board> boards, std::span<const std::uint32_t> scores,
+                    const SpectatorLayout &layout);
+    void DrawScoreBoard(std::uint64_t score, std::uint64_t best, const ScoreBoardLayout &layout) const;
     void DrawInitScreen(const MessageLayout &layout) const;
     void DrawEndGameMessage(const MessageLayout &layout, const GameState &state) const;
+    void DrawHint(std::string_view hint, const ScoreBoardLayout &layout) const;
+    void DrawOverlay(const FrameStats &stats, const OverlayLayout &layout);
 };
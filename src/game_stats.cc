@@ -0,0 +1,223 @@
+#include "game_stats.h"
+#include "mapped_file.h"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+// records per task: enough work to amortize the task, small enough to balance the threads
+constexpr size_t RANGE_RECORDS = 4096;
+
+struct RecordRange
+{
+    size_t file;
+    size_t begin;
+    size_t end;
+};
+
+struct RecordFile
+{
+    std::optional<MappedFile> mapped;
+    std::vector<RecordRange> ranges;
+    // the last record was cut short, e.g. by a writer that was killed
+    bool truncated = false;
+    std::exception_ptr error;
+};
+
+void GameStats::Add(const ReplayResult &result)
+{
+    if (!result.valid)
+    {
+        ++invalid;
+        return;
+    }
+
+    ++games;
+    moves += result.moves;
+    ++max_tiles.at(result.max_exponent);
+    scores.push_back(result.score);
+    lengths.push_back(result.moves);
+
+    for (size_t dir = 0; dir < directions.size(); ++dir)
+    {
+        directions.at(dir) += result.directions.at(dir);
+    }
+}
+
+void GameStats::Merge(GameStats &&other)
+{
+    games += other.games;
+    moves += other.moves;
+    invalid += other.invalid;
+
+    for (size_t dir = 0; dir < directions.size(); ++dir)
+    {
+        directions.at(dir) += other.directions.at(dir);
+    }
+
+    for (size_t exponent = 0; exponent < max_tiles.size(); ++exponent)
+    {
+        max_tiles.at(exponent) += other.max_tiles.at(exponent);
+    }
+
+    scores.insert(scores.end(), other.scores.begin(), other.scores.end());
+    lengths.insert(lengths.end(), other.lengths.begin(), other.lengths.end());
+    other = {};
+}
+
+auto GameStats::ReachRate(const std::uint8_t exponent) const -> double
+{
+    if (games == 0)
+    {
+        return 0;
+    }
+
+    std::uint64_t reached = 0;
+
+    for (size_t i = exponent; i < max_tiles.size(); ++i)
+    {
+        reached += max_tiles.at(i);
+    }
+
+    return static_cast<double>(reached) / static_cast<double>(games);
+}
+
+auto FindRecordFiles(const std::vector<std::filesystem::path> &inputs) -> std::vector<std::filesystem::path>
+{
+    std::vector<std::filesystem::path> files;
+
+    for (const auto &input : inputs)
+    {
+        if (!std::filesystem::is_directory(input))
+        {
+            files.push_back(input);
+            continue;
+        }
+
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(input))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".rec")
+            {
+                files.push_back(entry.path());
+            }
+        }
+    }
+
+    std::ranges::sort(files);
+    return files;
+}
+
+// Runs task(index, thread) for every index below `count`, the threads taking the next index as they finish.
+void RunParallel(const size_t count, const unsigned threads, const std::function<void(size_t, unsigned)> &task)
+{
+    std::atomic<size_t> next = 0;
+
+    auto worker = [&](const unsigned id) {
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            task(i, id);
+        }
+    };
+
+    std::vector<std::jthread> pool;
+
+    for (unsigned id = 1; id < threads; ++id)
+    {
+        pool.emplace_back(worker, id);
+    }
+
+    worker(0);
+}
+
+// Maps the file and splits it into ranges of records: a walk over the record headers only.
+void IndexRecordFile(const std::filesystem::path &path, const size_t index, RecordFile &file)
+{
+    try
+    {
+        file.mapped.emplace(path);
+        GameRecordReader reader(file.mapped->Bytes());
+        GameRecordView record;
+        size_t begin = reader.Offset();
+        size_t records = 0;
+
+        try
+        {
+            while (reader.Next(record))
+            {
+                if (++records % RANGE_RECORDS == 0)
+                {
+                    file.ranges.push_back({index, begin, reader.Offset()});
+                    begin = reader.Offset();
+                }
+            }
+        }
+        catch (const std::runtime_error &)
+        {
+            file.truncated = true;
+        }
+
+        if (reader.Offset() > begin)
+        {
+            file.ranges.push_back({index, begin, reader.Offset()});
+        }
+    }
+    catch (...)
+    {
+        file.error = std::current_exception();
+    }
+}
+
+auto CollectGameStats(const std::vector<std::filesystem::path> &files, unsigned threads) -> GameStats
+{
+    threads = std::max(threads, 1U);
+
+    // map: index the files in parallel, then replay their ranges in parallel
+    std::vector<RecordFile> record_files(files.size());
+
+    RunParallel(files.size(), threads, [&](const size_t index, unsigned) {
+        IndexRecordFile(files.at(index), index, record_files.at(index));
+    });
+
+    std::vector<RecordRange> ranges;
+    std::uint64_t truncated = 0;
+
+    for (const auto &file : record_files)
+    {
+        if (file.error)
+        {
+            std::rethrow_exception(file.error);
+        }
+
+        ranges.insert(ranges.end(), file.ranges.begin(), file.ranges.end());
+        truncated += file.truncated ? 1 : 0;
+    }
+
+    std::vector<GameStats> partial(threads);
+
+    RunParallel(ranges.size(), threads, [&](const size_t index, const unsigned id) {
+        const auto &[file, begin, end] = ranges.at(index);
+        GameRecordReader reader(record_files.at(file).mapped->Bytes());
+        GameRecordView record;
+        reader.Seek(begin);
+
+        while (reader.Offset() < end && reader.Next(record))
+        {
+            partial.at(id).Add(ReplayRecord(record));
+        }
+    });
+
+    // reduce
+    GameStats stats;
+    stats.invalid = truncated;
+
+    for (auto &part : partial)
+    {
+        stats.Merge(std::move(part));
+    }
+
+    return stats;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "game_record.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Aggregates of replayed games. Every worker fills its own and the results are merged at the end, so that the
+// replay itself shares nothing between threads.
+struct GameStats
+{
+    std::uint64_t games = 0;
+    std::uint64_t moves = 0;
+    // records whose moves do not follow the rules
+    std::uint64_t invalid = 0;
+    std::array<std::uint64_t, 4> directions = {};
+    // games by their largest tile
+    std::array<std::uint64_t, MAX_EXPONENT + 1> max_tiles = {};
+    std::vector<std::uint64_t> scores;
+    std::vector<std::uint32_t> lengths;
+
+    void Add(const ReplayResult &result);
+    void Merge(GameStats &&other);
+
+    // share of the games whose largest tile is at least 2^exponent
+    [[nodiscard]] auto ReachRate(std::uint8_t exponent) const -> double;
+};
+
+// Nearest-rank percentile: the smallest value that at least `percent` percent of the values do not exceed.
+// 0 for no values.
+template <typename T> auto Percentile(std::vector<T> values, const double percent) -> T
+{
+    if (values.empty())
+    {
+        return 0;
+    }
+
+    const auto rank = static_cast<size_t>(std::ceil(percent / 100 * static_cast<double>(values.size())));
+    const auto nth = values.begin() + static_cast<std::ptrdiff_t>(std::clamp<size_t>(rank, 1, values.size()) - 1);
+    std::ranges::nth_element(values, nth);
+    return *nth;
+}
+
+// The record files (*.rec) of directories, searched recursively, and files given directly.
+auto FindRecordFiles(const std::vector<std::filesystem::path> &inputs) -> std::vector<std::filesystem::path>;
+
+// Replays every record of the files on `threads` threads. Files are memory-mapped and split into ranges of records,
+// so that one large file keeps every thread busy too.
+auto CollectGameStats(const std::vector<std::filesystem::path> &files, unsigned threads) -> GameStats;
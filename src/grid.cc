@@ -65,7 +65,9 @@ auto Grid::AdjacentTiles(size_t row, size_t col) const -> std::vector<Tile>
     std::vector<Tile> neighbours;
     neighbours.reserve(4);
 
-    for (const auto &[row_off, col_off] : std::vector<std::pair<int, int>>{{0, 1}, {0, -1}, {1, 0}, {-1, 0}})
+    constexpr std::array<std::pair<int, int>, 4> OFFSETS = {{{0, 1}, {0, -1}, {1, 0}, {-1, 0}}};
+
+    for (const auto &[row_off, col_off] : OFFSETS)
     {
         if (IsValidPosition(row + row_off, col + col_off))
         {
@@ -5,11 +5,13 @@
 #include <cstdint>
 #include <vector>
 
+constexpr size_t GRID_TILES = 16;
+
 struct Tile
 {
     size_t row;
     size_t col;
-    uint16_t value;
+    std::uint32_t value;
 };
 
 class Grid
@@ -17,7 +19,7 @@ class Grid
   private:
     size_t n_rows = 4;
     size_t n_cols = 4;
-    std::array<Tile, 16> tiles = {};
+    std::array<Tile, GRID_TILES> tiles = {};
 
   private:
     [[nodiscard]] auto IsValidPosition(size_t row, size_t col) const -> bool;
@@ -0,0 +1,91 @@
+#include "heuristic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+auto ScoreRow(const BoardRow row, const HeuristicWeights &weights) -> float
+{
+    std::array<int, BOARD_SIZE> line = {};
+
+    for (size_t col = 0; col < BOARD_SIZE; ++col)
+    {
+        line.at(col) = (row >> (4 * col)) & 0xf;
+    }
+
+    int empty = 0;
+    int merges = 0;
+    int smoothness = 0;
+    int previous = 0;
+
+    for (const int exponent : line)
+    {
+        if (exponent == 0)
+        {
+            ++empty;
+            continue;
+        }
+
+        // gaps do not stop a merge, the tiles slide together first
+        if (previous != 0)
+        {
+            merges += previous == exponent ? 1 : 0;
+            smoothness += std::abs(previous - exponent);
+        }
+
+        previous = exponent;
+    }
+
+    float rising = 0;
+    float falling = 0;
+
+    for (size_t col = 1; col < BOARD_SIZE; ++col)
+    {
+        const auto left = std::pow(static_cast<float>(line.at(col - 1)), weights.monotonicity_power);
+        const auto right = std::pow(static_cast<float>(line.at(col)), weights.monotonicity_power);
+
+        (left > right ? falling : rising) += std::abs(left - right);
+    }
+
+    const auto first = static_cast<float>(line.front());
+    const auto last = static_cast<float>(line.back());
+
+    return weights.alive + weights.empty * static_cast<float>(empty) + weights.merges * static_cast<float>(merges) -
+           weights.monotonicity * std::min(rising, falling) - weights.smoothness * static_cast<float>(smoothness) +
+           weights.corner * (first * first + last * last);
+}
+
+HeuristicEvaluator::HeuristicEvaluator(const HeuristicWeights &weights)
+{
+    auto table = std::make_shared<std::array<float, 65536>>();
+
+    for (size_t row = 0; row < table->size(); ++row)
+    {
+        table->at(row) = ScoreRow(static_cast<BoardRow>(row), weights);
+    }
+
+    rows = std::move(table);
+}
+
+auto HeuristicEvaluator::RowScore(const BoardRow row) const -> float
+{
+    return (*rows)[row];
+}
+
+auto HeuristicEvaluator::operator()(const Board board) const -> float
+{
+    const auto &table = *rows;
+    const Board transposed = Transpose(board);
+
+    const float score = table[GetRow(board, 0)] + table[GetRow(board, 1)] + table[GetRow(board, 2)] +
+                        table[GetRow(board, 3)] + table[GetRow(transposed, 0)] + table[GetRow(transposed, 1)] +
+                        table[GetRow(transposed, 2)] + table[GetRow(transposed, 3)];
+
+    return std::max(score, LIVE_FLOOR);
+}
+
+auto EvaluateHeuristic(const Board board) -> float
+{
+    static const HeuristicEvaluator evaluator;
+    return evaluator(board);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "board.h"
+
+#include <array>
+#include <memory>
+
+// Weights of the heuristic terms, per row and per column.
+struct HeuristicWeights
+{
+    // per row and column, it lifts ordinary positions well above the 0 of a lost one, though the penalties of extreme
+    // boards can outweigh it
+    float alive = 200000.0f;
+    float empty = 270.0f;
+    // equal neighbours, which can merge on the next move
+    float merges = 700.0f;
+    // penalty on the rise (or fall) of exponent^monotonicity_power against the row's best direction
+    float monotonicity = 47.0f;
+    float monotonicity_power = 4.0f;
+    // penalty per exponent of difference between neighbouring tiles
+    float smoothness = 10.0f;
+    // bonus on exponent^2 of the tiles at both ends: summed over rows and columns, corners count twice
+    float corner = 5.0f;
+};
+
+// Scores boards on monotonicity, smoothness, empty cells, merge potential and corners. A row scores the same
+// wherever it is on the board, so the score of every possible row is precomputed and a board costs 8 lookups:
+// its 4 rows and the 4 rows of its transpose. Copies share the table.
+//
+// The search scores a lost board 0, so a board is never evaluated below LIVE_FLOOR: a live position, however bad,
+// always beats losing.
+class HeuristicEvaluator
+{
+  private:
+    std::shared_ptr<const std::array<float, 65536>> rows;
+
+  public:
+    static constexpr float LIVE_FLOOR = 1.0f;
+
+    explicit HeuristicEvaluator(const HeuristicWeights &weights = {});
+
+    [[nodiscard]] auto RowScore(BoardRow row) const -> float;
+    auto operator()(Board board) const -> float;
+};
+
+// HeuristicEvaluator with the default weights, the default evaluator of the search.
+auto EvaluateHeuristic(Board board) -> float;
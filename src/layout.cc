@@ -1,5 +1,23 @@
 #include "layout.h"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+MessageLayout::MessageLayout(const SDL_FRect &rect, const float scale) : rect(rect)
+{
+    offset_y *= scale;
+    title_font_size *= scale;
+    subtitle_font_size *= scale;
+    vertical_gap *= scale;
+
+    init_title_padding_x *= scale;
+    init_subtitle_padding_x *= scale;
+    end_title_padding_x *= scale;
+    end_subtitle_padding_x *= scale;
+    padding_y *= scale;
+}
+
 auto MessageLayout::TotalSize() const -> float
 {
     return title_font_size + subtitle_font_size + vertical_gap;
@@ -29,6 +47,23 @@ auto MessageLayout::SubtitleRect() const -> SDL_FRect
     return subtitle_rect;
 }
 
+ScoreBoardLayout::ScoreBoardLayout(const SDL_FRect &score_board_rect, const float scale) : rect(score_board_rect)
+{
+    middle_gap *= scale;
+    box_height *= scale;
+    box_width = (rect.w - middle_gap) / 2.0f;
+
+    label_font_size *= scale;
+    label_padding_x *= scale;
+    label_padding_y *= scale;
+
+    value_font_size *= scale;
+    value_padding_x *= scale;
+    value_padding_y *= scale;
+
+    hint_font_size *= scale;
+}
+
 auto ScoreBoardLayout::ScoreRect() const -> SDL_FRect
 {
     return SDL_FRect(rect.x, rect.y, box_width, box_height);
@@ -39,33 +74,196 @@ auto ScoreBoardLayout::BestRect() const -> SDL_FRect
     return SDL_FRect(rect.x + box_width + middle_gap, rect.y, box_width, box_height);
 }
 
+auto ScoreBoardLayout::HintRect() const -> SDL_FRect
+{
+    return SDL_FRect(rect.x, rect.y + box_height, rect.w, rect.h - box_height);
+}
+
+TileLayout::TileLayout(const SDL_FRect &rect, const float scale) : rect(rect)
+{
+    font_size *= scale;
+    padding *= scale;
+}
+
+GridLayout::GridLayout(const SDL_FRect &grid_rect, const float scale) : rect(grid_rect)
+{
+    tile_gap *= scale;
+    tile_size = (rect.w - static_cast<float>(GRID_SIDE + 1) * tile_gap) / static_cast<float>(GRID_SIDE);
+
+    for (size_t row = 0; row < GRID_SIDE; ++row)
+    {
+        for (size_t col = 0; col < GRID_SIDE; ++col)
+        {
+            const auto i = static_cast<float>(col);
+            const auto j = static_cast<float>(row);
+
+            SDL_FRect tile_rect;
+            tile_rect.x = rect.x + i * tile_size + (i + 1) * tile_gap;
+            tile_rect.y = rect.y + j * tile_size + (j + 1) * tile_gap;
+            tile_rect.w = tile_size;
+            tile_rect.h = tile_size;
+
+            tiles[row * GRID_SIDE + col] = TileLayout(tile_rect, scale);
+        }
+    }
+}
+
+auto GridLayout::GetTileLayout(const size_t row, const size_t col) const -> const TileLayout &
+{
+    return tiles[row * GRID_SIDE + col];
+}
+
+OverlayLayout::OverlayLayout(const SDL_FRect &rect, const float scale) : rect(rect)
+{
+    font_size *= scale;
+    line_height *= scale;
+    padding_x *= scale;
+    padding_y *= scale;
+}
+
+ApplicationLayout::ApplicationLayout(const int pixel_width, const int pixel_height)
+    : width(pixel_width), height(pixel_height),
+      scale(std::min(static_cast<float>(pixel_width) / DESIGN_WIDTH, static_cast<float>(pixel_height) / DESIGN_HEIGHT)),
+      origin_x((static_cast<float>(pixel_width) - DESIGN_WIDTH * scale) / 2),
+      origin_y((static_cast<float>(pixel_height) - DESIGN_HEIGHT * scale) / 2), grid_layout(GridRect(), scale),
+      score_board_layout(ScoreBoardRect(), scale), message_layout(GridRect(), scale),
+      overlay_layout(OverlayRect(), scale)
+{
+}
+
 constexpr auto ApplicationLayout::GridSize() const
 {
-    return static_cast<float>(width) - (pad_x + 10) * 2.0f + 15;
+    return static_cast<float>(DESIGN_WIDTH) - (pad_x + 10) * 2.0f + 15;
+}
+
+auto ApplicationLayout::ToPixels(const SDL_FRect &design_rect) const -> SDL_FRect
+{
+    return SDL_FRect(origin_x + design_rect.x * scale, origin_y + design_rect.y * scale, design_rect.w * scale,
+                     design_rect.h * scale);
 }
 
 auto ApplicationLayout::ScoreBoardRect() const -> SDL_FRect
 {
     const auto grid_size = GridSize();
-    return SDL_FRect(pad_x, pad_y, grid_size, 80);
+    return ToPixels(SDL_FRect(pad_x, pad_y, grid_size, 80));
 }
 
 auto ApplicationLayout::GridRect() const -> SDL_FRect
 {
     const auto grid_size = GridSize();
-    return SDL_FRect(pad_x, static_cast<float>(height) - grid_size - pad_y - 10, grid_size, grid_size);
+    return ToPixels(SDL_FRect(pad_x, static_cast<float>(DESIGN_HEIGHT) - grid_size - pad_y - 10, grid_size, grid_size));
 }
 
-auto GridLayout::GetTileLayout(const size_t row, const size_t col) const -> TileLayout
+auto ApplicationLayout::OverlayRect() const -> SDL_FRect
 {
-    const auto i = static_cast<float>(col);
-    const auto j = static_cast<float>(row);
+    // top left corner of the grid, tall enough for the five lines of the overlay
+    const auto grid_size = GridSize();
+    return ToPixels(
+        SDL_FRect(pad_x, static_cast<float>(DESIGN_HEIGHT) - grid_size - pad_y - 10, grid_size * 0.6f, 5 * 20 + 8));
+}
+
+auto OverlayLayout::LineRect(const size_t line) const -> SDL_FRect
+{
+    return SDL_FRect(rect.x + padding_x, rect.y + padding_y + static_cast<float>(line) * line_height,
+                     rect.w - 2 * padding_x, line_height);
+}
+
+SpectatorLayout::SpectatorLayout(const size_t boards, const int pixel_width, const int pixel_height,
+                                 const float scale)
+{
+    gap *= scale;
+    label_height *= scale;
+    label_font_size *= scale;
+
+    const auto width = static_cast<float>(pixel_width);
+    const auto height = static_cast<float>(pixel_height);
+    float side = 0;
+
+    // the number of columns that gives the largest boards
+    for (size_t candidate = 1; candidate <= std::max<size_t>(boards, 1); ++candidate)
+    {
+        const auto candidate_rows = (boards + candidate - 1) / candidate;
+        const auto cell_width = width / static_cast<float>(candidate);
+        const auto cell_height = height / static_cast<float>(std::max<size_t>(candidate_rows, 1));
+        const auto candidate_side = std::min(cell_width, cell_height - label_height) - gap;
+
+        if (candidate_side > side)
+        {
+            side = candidate_side;
+            columns = candidate;
+            rows = candidate_rows;
+        }
+    }
+
+    side = std::max(side, 1.0f);
+
+    // the table is centered, like the design of the single game
+    const auto cell_width = side + gap;
+    const auto cell_height = side + label_height + gap;
+    const auto origin_x = (width - cell_width * static_cast<float>(columns) + gap) / 2;
+    const auto origin_y = (height - cell_height * static_cast<float>(rows) + gap) / 2;
+    // gaps and fonts of a miniature grid shrink with it
+    const auto grid_scale = side / static_cast<float>(ApplicationLayout::DESIGN_WIDTH);
+
+    grids.reserve(boards);
+    labels.reserve(boards);
+
+    for (size_t board = 0; board < boards; ++board)
+    {
+        const auto x = origin_x + static_cast<float>(board % columns) * cell_width;
+        const auto y = origin_y + static_cast<float>(board / columns) * cell_height;
+
+        grids.emplace_back(SDL_FRect(x, y, side, side), grid_scale);
+        labels.emplace_back(x, y + side, side, label_height);
+    }
+}
+
+auto TileStyleFor(const std::uint32_t value) -> TileStyle
+{
+    const auto exponent = value == 0 ? 0 : static_cast<size_t>(std::bit_width(value) - 1);
+
+    if (exponent < tile_colors.size())
+    {
+        return tile_colors.at(exponent);
+    }
+
+    // dark tiles whose hue turns by a fixed step per exponent, so that neighbouring values never look alike
+    constexpr float VALUE = 0.36f;
+    constexpr float SATURATION = 0.6f;
+    constexpr float HUE_STEP = 47;
+
+    const auto hue = std::fmod(static_cast<float>(exponent - tile_colors.size()) * HUE_STEP, 360.0f) / 60.0f;
+    const auto chroma = VALUE * SATURATION;
+    const auto second = chroma * (1 - std::abs(std::fmod(hue, 2.0f) - 1));
+    const auto base = VALUE - chroma;
+
+    std::array<float, 3> rgb = {};
+
+    switch (static_cast<int>(hue))
+    {
+    case 0:
+        rgb = {chroma, second, 0};
+        break;
+    case 1:
+        rgb = {second, chroma, 0};
+        break;
+    case 2:
+        rgb = {0, chroma, second};
+        break;
+    case 3:
+        rgb = {0, second, chroma};
+        break;
+    case 4:
+        rgb = {second, 0, chroma};
+        break;
+    default:
+        rgb = {chroma, 0, second};
+        break;
+    }
 
-    SDL_FRect tile_rect;
-    tile_rect.x = rect.x + i * tile_size + (i + 1) * tile_gap;
-    tile_rect.y = rect.y + j * tile_size + (j + 1) * tile_gap;
-    tile_rect.w = tile_size;
-    tile_rect.h = tile_size;
+    const auto channel = [base](const float component) {
+        return static_cast<Uint8>(std::lround((component + base) * 255));
+    };
 
-    return TileLayout(tile_rect);
+    return {SDL_Color(channel(rgb[0]), channel(rgb[1]), channel(rgb[2]), 0xff), TileStyle::LightText};
 }
@@ -2,6 +2,12 @@
 
 #include <SDL3/SDL.h>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr size_t GRID_SIDE = 4;
+constexpr size_t GRID_CELLS = GRID_SIDE * GRID_SIDE;
 
 struct MessageLayout
 {
@@ -21,9 +27,7 @@ struct MessageLayout
     float end_subtitle_padding_x = 10;
     float padding_y = 0;
 
-    explicit MessageLayout(const SDL_FRect &rect) : rect(rect)
-    {
-    }
+    MessageLayout(const SDL_FRect &rect, float scale);
 
     [[nodiscard]] auto TitleRect() const -> SDL_FRect;
     [[nodiscard]] auto SubtitleRect() const -> SDL_FRect;
@@ -51,13 +55,13 @@ struct ScoreBoardLayout
     float value_padding_x = 10;
     float value_padding_y = 10;
 
-    explicit ScoreBoardLayout(const SDL_FRect &score_board_rect)
-        : rect(score_board_rect), box_width((rect.w - middle_gap) / 2.0f)
-    {
-    }
+    float hint_font_size = 16;
+
+    ScoreBoardLayout(const SDL_FRect &score_board_rect, float scale);
 
     [[nodiscard]] auto ScoreRect() const -> SDL_FRect;
     [[nodiscard]] auto BestRect() const -> SDL_FRect;
+    [[nodiscard]] auto HintRect() const -> SDL_FRect;
 };
 
 struct TileStyle
@@ -71,14 +75,13 @@ struct TileStyle
 
 struct TileLayout
 {
-    SDL_FRect rect;
+    SDL_FRect rect = {};
 
     float font_size = 50;
     float padding = 20;
 
-    explicit TileLayout(const SDL_FRect &rect) : rect(rect)
-    {
-    }
+    TileLayout() = default;
+    TileLayout(const SDL_FRect &rect, float scale);
 };
 
 struct GridLayout
@@ -90,13 +93,49 @@ struct GridLayout
 
     float tile_gap = 15;
     float tile_size = 100;
-    float tile_offset = 100;
 
-    explicit GridLayout(const SDL_FRect &grid_rect) : rect(grid_rect)
-    {
-    }
+    // computed once per layout, row-major
+    std::array<TileLayout, GRID_CELLS> tiles;
+
+    GridLayout(const SDL_FRect &grid_rect, float scale);
+
+    [[nodiscard]] auto GetTileLayout(size_t row, size_t col) const -> const TileLayout &;
+};
+
+struct OverlayLayout
+{
+    SDL_Color fg_color = {255, 255, 255, 0xff};
+    SDL_Color bg_color = {0, 0, 0, 170};
+
+    SDL_FRect rect;
+
+    float font_size = 14;
+    float line_height = 20;
+    float padding_x = 8;
+    float padding_y = 4;
 
-    [[nodiscard]] auto GetTileLayout(size_t row, size_t col) const -> TileLayout;
+    OverlayLayout(const SDL_FRect &rect, float scale);
+
+    [[nodiscard]] auto LineRect(size_t line) const -> SDL_FRect;
+};
+
+// Many games at once: a miniature grid per game with its score below, in a table as square as the output allows.
+struct SpectatorLayout
+{
+    SDL_Color bg_color = {0xfa, 0xf8, 0xef, 0xff};
+    SDL_Color label_color = {0x77, 0x6e, 0x65, 0xff};
+
+    size_t columns = 1;
+    size_t rows = 1;
+    float gap = 12;
+    float label_height = 14;
+    float label_font_size = 12;
+
+    std::vector<GridLayout> grids;
+    std::vector<SDL_FRect> labels;
+
+    SpectatorLayout() = default;
+    SpectatorLayout(size_t boards, int pixel_width, int pixel_height, float scale);
 };
 
 static constexpr std::array tile_colors = {
@@ -114,22 +153,37 @@ static constexpr std::array tile_colors = {
     TileStyle(SDL_Color(0xed, 0xc2, 0x2e, 0xff), TileStyle::LightText),
 };
 
+// style of a tile value: the classic colours up to 2048, generated ones for the larger tiles of endless games
+auto TileStyleFor(std::uint32_t value) -> TileStyle;
+
+// Every length in the layouts is a design value for a 540x600 window, multiplied once by `scale` when the layout
+// is computed: the layouts hold final pixel coordinates, so drawing never scales anything. The design is centered in
+// the output, which may have a different aspect ratio.
 struct ApplicationLayout
 {
-    int height = 600;
-    int width = 540;
+    static constexpr int DESIGN_WIDTH = 540;
+    static constexpr int DESIGN_HEIGHT = 600;
+
+    // output size in pixels
+    int width = DESIGN_WIDTH;
+    int height = DESIGN_HEIGHT;
     float pad_x = 30;
     float pad_y = 20;
 
+    float scale = 1;
+    float origin_x = 0;
+    float origin_y = 0;
+
     GridLayout grid_layout;
     ScoreBoardLayout score_board_layout;
     MessageLayout message_layout;
+    OverlayLayout overlay_layout;
 
-    ApplicationLayout() : grid_layout(GridRect()), score_board_layout(ScoreBoardRect()), message_layout(GridRect())
-    {
-    }
+    explicit ApplicationLayout(int pixel_width = DESIGN_WIDTH, int pixel_height = DESIGN_HEIGHT);
 
     [[nodiscard]] constexpr auto GridSize() const;
+    [[nodiscard]] auto ToPixels(const SDL_FRect &design_rect) const -> SDL_FRect;
     [[nodiscard]] auto ScoreBoardRect() const -> SDL_FRect;
     [[nodiscard]] auto GridRect() const -> SDL_FRect;
-};
\ No newline at end of file
+    [[nodiscard]] auto OverlayRect() const -> SDL_FRect;
+};
@@ -0,0 +1,106 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define C2048_HAS_MMAP 1
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+{
+#ifdef C2048_HAS_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        throw std::runtime_error("unable to open " + path.string());
+    }
+
+    struct stat info = {};
+
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("unable to stat " + path.string());
+    }
+
+    size = static_cast<size_t>(info.st_size);
+
+    if (size > 0)
+    {
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("unable to map " + path.string());
+        }
+
+        data = static_cast<const std::byte *>(mapping);
+    }
+
+    // the mapping keeps its own reference to the file
+    close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+
+    if (!in)
+    {
+        throw std::runtime_error("unable to open " + path.string());
+    }
+
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+    data = buffer.data();
+    size = buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    Unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), buffer(std::move(other.buffer))
+{
+}
+
+auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile &
+{
+    if (this != &other)
+    {
+        Unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+        buffer = std::move(other.buffer);
+    }
+
+    return *this;
+}
+
+void MappedFile::Unmap()
+{
+#ifdef C2048_HAS_MMAP
+    if (data != nullptr)
+    {
+        munmap(const_cast<std::byte *>(data), size);
+    }
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
+auto MappedFile::Bytes() const -> std::span<const std::byte>
+{
+    return {data, size};
+}
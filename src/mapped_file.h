@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Read-only view of a whole file. Files are memory-mapped where the platform allows it, so large tables and
+// archives are paged in on demand instead of being copied into the heap.
+class MappedFile
+{
+  private:
+    const std::byte *data = nullptr;
+    size_t size = 0;
+    std::vector<std::byte> buffer;
+
+  private:
+    void Unmap();
+
+  public:
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+    auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+
+    [[nodiscard]] auto Bytes() const -> std::span<const std::byte>;
+};
@@ -0,0 +1,226 @@
+#include "ntuple.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+constexpr std::array<char, 8> NTUPLE_MAGIC = {'C', '2', '0', '4', '8', 'N', 'T', '\0'};
+constexpr std::uint32_t NTUPLE_VERSION = 1;
+constexpr size_t SYMMETRIES = 8;
+constexpr size_t MAX_TUPLE_SIZE = 6;
+
+// Applies one of the 8 board symmetries to a cell: `symmetry` % 4 quarter turns, mirrored when >= 4.
+auto TransformCell(const std::uint8_t cell, const size_t symmetry) -> std::uint8_t
+{
+    size_t row = cell / BOARD_SIZE;
+    size_t col = cell % BOARD_SIZE;
+
+    for (size_t turn = 0; turn < symmetry % 4; ++turn)
+    {
+        const size_t rotated_row = col;
+        col = BOARD_SIZE - 1 - row;
+        row = rotated_row;
+    }
+
+    if (symmetry >= 4)
+    {
+        col = BOARD_SIZE - 1 - col;
+    }
+
+    return static_cast<std::uint8_t>(row * BOARD_SIZE + col);
+}
+
+NTupleNetwork::NTupleNetwork(std::vector<TupleCells> tuples) : tuples(std::move(tuples))
+{
+    size_t n_weights = 0;
+
+    for (const auto &tuple : this->tuples)
+    {
+        if (tuple.empty() || tuple.size() > MAX_TUPLE_SIZE)
+        {
+            throw std::invalid_argument("tuples must have between 1 and 6 cells");
+        }
+
+        for (size_t symmetry = 0; symmetry < SYMMETRIES; ++symmetry)
+        {
+            TupleCells variant;
+
+            for (const auto cell : tuple)
+            {
+                if (cell >= BOARD_CELLS)
+                {
+                    throw std::invalid_argument("tuple cell out of the board");
+                }
+
+                variant.push_back(TransformCell(cell, symmetry));
+            }
+
+            variants.push_back(std::move(variant));
+            offsets.push_back(n_weights);
+        }
+
+        n_weights += size_t{1} << (4 * tuple.size());
+    }
+
+    weights = std::vector<std::atomic<float>>(n_weights);
+}
+
+auto NTupleNetwork::Standard() -> NTupleNetwork
+{
+    return NTupleNetwork({
+        {0, 1, 2, 3, 4, 5},
+        {4, 5, 6, 7, 8, 9},
+        {0, 1, 2, 4, 5, 6},
+        {4, 5, 6, 8, 9, 10},
+    });
+}
+
+auto NTupleNetwork::Tuples() const -> const std::vector<TupleCells> &
+{
+    return tuples;
+}
+
+auto NTupleNetwork::FeatureIndex(const Board board, const size_t variant) const -> size_t
+{
+    size_t index = 0;
+    size_t shift = 0;
+
+    for (const auto cell : variants[variant])
+    {
+        index |= static_cast<size_t>(GetCell(board, cell)) << shift;
+        shift += 4;
+    }
+
+    return offsets[variant] + index;
+}
+
+auto NTupleNetwork::Evaluate(const Board board) const -> float
+{
+    float value = 0;
+
+    for (size_t variant = 0; variant < variants.size(); ++variant)
+    {
+        value += weights[FeatureIndex(board, variant)].load(std::memory_order_relaxed);
+    }
+
+    return value;
+}
+
+auto NTupleNetwork::EvaluateState(const Board board) const -> float
+{
+    float best = 0;
+    bool has_move = false;
+
+    for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+    {
+        const auto [after, score] = MoveBoard(board, dir);
+
+        if (after == board)
+        {
+            continue;
+        }
+
+        const float value = static_cast<float>(score) + Evaluate(after);
+        best = has_move ? std::max(best, value) : value;
+        has_move = true;
+    }
+
+    return best;
+}
+
+void NTupleNetwork::Update(const Board board, const float delta)
+{
+    // the error is shared evenly by all the features that contributed to the value
+    const float step = delta / static_cast<float>(variants.size());
+
+    for (size_t variant = 0; variant < variants.size(); ++variant)
+    {
+        auto &weight = weights[FeatureIndex(board, variant)];
+        weight.store(weight.load(std::memory_order_relaxed) + step, std::memory_order_relaxed);
+    }
+}
+
+void NTupleNetwork::Save(const std::filesystem::path &path) const
+{
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+
+        const auto n_tuples = static_cast<std::uint32_t>(tuples.size());
+        out.write(NTUPLE_MAGIC.data(), NTUPLE_MAGIC.size());
+        out.write(reinterpret_cast<const char *>(&NTUPLE_VERSION), sizeof(NTUPLE_VERSION));
+        out.write(reinterpret_cast<const char *>(&n_tuples), sizeof(n_tuples));
+
+        for (const auto &tuple : tuples)
+        {
+            const auto size = static_cast<std::uint8_t>(tuple.size());
+            out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            out.write(reinterpret_cast<const char *>(tuple.data()), static_cast<std::streamsize>(tuple.size()));
+        }
+
+        for (const auto &weight : weights)
+        {
+            const float value = weight.load(std::memory_order_relaxed);
+            out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        if (!out)
+        {
+            throw std::runtime_error("failed to write " + tmp_path.string());
+        }
+    }
+
+    // training keeps running while checkpoints are written, never expose a partial file
+    std::filesystem::rename(tmp_path, path);
+}
+
+auto NTupleNetwork::Load(const std::filesystem::path &path) -> NTupleNetwork
+{
+    std::ifstream in(path, std::ios::binary);
+    std::array<char, 8> magic = {};
+    std::uint32_t version = 0;
+    std::uint32_t n_tuples = 0;
+
+    in.read(magic.data(), magic.size());
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&n_tuples), sizeof(n_tuples));
+
+    if (!in || magic != NTUPLE_MAGIC || version != NTUPLE_VERSION)
+    {
+        throw std::runtime_error(path.string() + " is not an n-tuple network");
+    }
+
+    std::vector<TupleCells> tuples(n_tuples);
+
+    for (auto &tuple : tuples)
+    {
+        std::uint8_t size = 0;
+        in.read(reinterpret_cast<char *>(&size), sizeof(size));
+        tuple.resize(size);
+        in.read(reinterpret_cast<char *>(tuple.data()), size);
+    }
+
+    if (!in)
+    {
+        throw std::runtime_error(path.string() + " is truncated");
+    }
+
+    NTupleNetwork network(std::move(tuples));
+
+    for (auto &weight : network.weights)
+    {
+        float value = 0;
+        in.read(reinterpret_cast<char *>(&value), sizeof(value));
+        weight.store(value, std::memory_order_relaxed);
+    }
+
+    if (!in)
+    {
+        throw std::runtime_error(path.string() + " is truncated");
+    }
+
+    return network;
+}
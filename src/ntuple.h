@@ -0,0 +1,44 @@
+#pragma once
+
+#include "board.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+using TupleCells = std::vector<std::uint8_t>;
+
+// N-tuple network: every tuple reads the exponents of a few cells as an index into its own weight table, and
+// the value of a board is the sum of the weights selected by all tuples. Each tuple is sampled in the 8
+// symmetric orientations of the board, so rotated and mirrored positions share the same weights.
+//
+// Weights are relaxed atomics: concurrent trainers update them without locks (Hogwild), which compiles to
+// plain loads and stores on common hardware.
+class NTupleNetwork
+{
+  private:
+    std::vector<TupleCells> tuples;
+    // the 8 symmetric variants of every tuple, in tuple order
+    std::vector<TupleCells> variants;
+    std::vector<size_t> offsets;
+    std::vector<std::atomic<float>> weights;
+
+  private:
+    [[nodiscard]] auto FeatureIndex(Board board, size_t variant) const -> size_t;
+
+  public:
+    explicit NTupleNetwork(std::vector<TupleCells> tuples);
+
+    // the four 6-tuples of Yeh et al., 64 MiB of weights each
+    static auto Standard() -> NTupleNetwork;
+    static auto Load(const std::filesystem::path &path) -> NTupleNetwork;
+
+    [[nodiscard]] auto Tuples() const -> const std::vector<TupleCells> &;
+    [[nodiscard]] auto Evaluate(Board board) const -> float;
+    // value of a position before the player moves: the best reward plus value of the resulting board
+    [[nodiscard]] auto EvaluateState(Board board) const -> float;
+    void Update(Board board, float delta);
+    // through `path`.tmp, renamed into place: concurrent saves to one path must be serialized by the caller
+    void Save(const std::filesystem::path &path) const;
+};
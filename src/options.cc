@@ -0,0 +1,101 @@
+#include "options.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+auto ParseSize(const std::string_view option, const std::string &value) -> size_t
+{
+    size_t end = 0;
+    size_t parsed = 0;
+
+    try
+    {
+        parsed = std::stoull(value, &end);
+    }
+    catch (const std::exception &)
+    {
+        end = 0;
+    }
+
+    if (end == 0 || end != value.size())
+    {
+        throw std::invalid_argument(std::format("{} expects a number, got '{}'", option, value));
+    }
+
+    return parsed;
+}
+
+auto ParseOptions(const int argc, char **argv) -> ApplicationOptions
+{
+    ApplicationOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view option = argv[i];
+
+        if (option == "--huge-pages")
+        {
+            options.huge_pages = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument(std::format("unknown option or missing value: {}", option));
+        }
+
+        const std::string value = argv[++i];
+
+        if (option == "--hash")
+        {
+            options.hash_megabytes = ParseSize(option, value);
+        }
+        else if (option == "--hash-file")
+        {
+            options.hash_file = value;
+        }
+        else if (option == "--ai-depth")
+        {
+            options.ai_depth = static_cast<int>(std::clamp<size_t>(ParseSize(option, value), 1, MAX_AI_DEPTH));
+        }
+        else if (option == "--hint-ms")
+        {
+            options.hint_ms = static_cast<int>(std::clamp<size_t>(ParseSize(option, value), 1, 10000));
+        }
+        else if (option == "--publish")
+        {
+            options.publish = value;
+        }
+        else if (option == "--spectate")
+        {
+            options.spectate = std::clamp<size_t>(ParseSize(option, value), 1, 256);
+        }
+        else if (option == "--autoplay-rate")
+        {
+            options.autoplay_rate = static_cast<double>(std::max<size_t>(ParseSize(option, value), 1));
+        }
+        else
+        {
+            throw std::invalid_argument(std::format("unknown option: {}", option));
+        }
+    }
+
+    return options;
+}
+
+auto OptionsUsage() -> std::string
+{
+    return "usage: 2048 [options]\n"
+           "  --hash <MB>      memory budget of the AI transposition table (default 64)\n"
+           "  --huge-pages     back the transposition table with huge pages when available\n"
+           "  --hash-file <path>\n"
+           "                   keep the transposition table in a file, shared with other processes using it\n"
+           "  --ai-depth <n>   search depth of the hint (H) and autoplay (P) AI (default 3)\n"
+           "  --hint-ms <ms>   deepen the AI search until this deadline instead of a fixed depth\n"
+           "  --autoplay-rate <moves/s>\n"
+           "                   speed of the autoplay (default 4)\n"
+           "  --publish <name> publish every move into a shared memory object, for 2048_viewer\n"
+           "  --spectate <n>   watch n games played by the AI at the autoplay rate (up to 256)\n";
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// deepest search of the AI, which --hint-ms deepens to when time allows
+constexpr int MAX_AI_DEPTH = 8;
+
+struct ApplicationOptions
+{
+    // memory budget of the transposition table shared by the AI
+    size_t hash_megabytes = 64;
+    bool huge_pages = false;
+    // file that keeps the transposition table between runs and shares it with other processes, none when empty
+    std::string hash_file;
+    // search depth of the hint and autoplay AI
+    int ai_depth = 3;
+    // when positive, the AI deepens its search until this deadline instead of searching ai_depth
+    int hint_ms = 0;
+    double autoplay_rate = 4;
+    // shared memory object the game is published into for 2048_viewer and other processes, none when empty
+    std::string publish;
+    // when positive, the window watches this many games played by the AI instead of playing one
+    size_t spectate = 0;
+};
+
+// Throws std::invalid_argument on unknown options or malformed values.
+auto ParseOptions(int argc, char **argv) -> ApplicationOptions;
+
+auto OptionsUsage() -> std::string;
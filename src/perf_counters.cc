@@ -0,0 +1,179 @@
+#include "perf_counters.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define C2048_HAS_PERF 1
+#endif
+
+auto PerfReading::Get(const PerfEvent event) const -> std::optional<std::uint64_t>
+{
+    return values[static_cast<size_t>(event)];
+}
+
+auto PerfReading::Ratio(const PerfEvent numerator, const PerfEvent denominator) const -> std::optional<double>
+{
+    const auto top = Get(numerator);
+    const auto bottom = Get(denominator);
+
+    if (!top || !bottom || *bottom == 0)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<double>(*top) / static_cast<double>(*bottom);
+}
+
+auto PerfReading::PerOperation(const PerfEvent event, const std::uint64_t operations) const -> std::optional<double>
+{
+    const auto value = Get(event);
+
+    if (!value || operations == 0)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<double>(*value) / static_cast<double>(operations);
+}
+
+#ifdef C2048_HAS_PERF
+auto OpenPerfEvent(const PerfEvent event) -> int
+{
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    constexpr auto cache_miss = [](const std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    };
+
+    switch (event)
+    {
+    case PerfEvent::Cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PerfEvent::Instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PerfEvent::BranchMisses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case PerfEvent::L1DataMisses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = cache_miss(PERF_COUNT_HW_CACHE_L1D);
+        break;
+    case PerfEvent::LlcMisses:
+    default:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = cache_miss(PERF_COUNT_HW_CACHE_LL);
+        break;
+    }
+
+    // this thread, any CPU, no group
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+PerfCounters::PerfCounters()
+{
+    fds.fill(-1);
+
+#ifdef C2048_HAS_PERF
+    for (size_t i = 0; i < PERF_EVENTS; ++i)
+    {
+        fds[i] = OpenPerfEvent(static_cast<PerfEvent>(i));
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef C2048_HAS_PERF
+    for (const int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+auto PerfCounters::Available() const -> bool
+{
+    return std::ranges::any_of(fds, [](const int fd) { return fd >= 0; });
+}
+
+void PerfCounters::Start()
+{
+#ifdef C2048_HAS_PERF
+    for (const int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+auto PerfCounters::Stop() -> PerfReading
+{
+    PerfReading reading;
+
+#ifdef C2048_HAS_PERF
+    for (const int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t i = 0; i < PERF_EVENTS; ++i)
+    {
+        // value, time enabled, time running
+        std::array<std::uint64_t, 3> data = {};
+
+        if (fds[i] < 0 || read(fds[i], data.data(), sizeof(data)) != sizeof(data) || data[2] == 0)
+        {
+            continue;
+        }
+
+        // the counter only ran for part of the region when the PMU had to multiplex it
+        reading.values[i] = static_cast<std::uint64_t>(static_cast<double>(data[0]) * static_cast<double>(data[1]) /
+                                                       static_cast<double>(data[2]));
+    }
+#endif
+
+    return reading;
+}
+
+auto PerfEventName(const PerfEvent event) -> std::string_view
+{
+    switch (event)
+    {
+    case PerfEvent::Cycles:
+        return "cycles";
+    case PerfEvent::Instructions:
+        return "instructions";
+    case PerfEvent::BranchMisses:
+        return "branch-misses";
+    case PerfEvent::L1DataMisses:
+        return "L1d-misses";
+    case PerfEvent::LlcMisses:
+    default:
+        return "LLC-misses";
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+enum class PerfEvent : std::uint8_t
+{
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1DataMisses,
+    LlcMisses,
+};
+
+constexpr size_t PERF_EVENTS = 5;
+
+struct PerfReading
+{
+    // nullopt for the events the kernel or the CPU does not provide
+    std::array<std::optional<std::uint64_t>, PERF_EVENTS> values;
+
+    [[nodiscard]] auto Get(PerfEvent event) const -> std::optional<std::uint64_t>;
+    // numerator / denominator when both were counted, e.g. instructions per cycle
+    [[nodiscard]] auto Ratio(PerfEvent numerator, PerfEvent denominator) const -> std::optional<double>;
+    [[nodiscard]] auto PerOperation(PerfEvent event, std::uint64_t operations) const -> std::optional<double>;
+};
+
+// Hardware counters of the calling thread, read through Linux perf_event_open around a measured region. Counters
+// that cannot be opened (other systems, virtual machines, a restrictive perf_event_paranoid) are skipped, so the
+// measured code runs the same either way. Multiplexed counters are scaled to the whole region.
+class PerfCounters
+{
+  private:
+    std::array<int, PERF_EVENTS> fds;
+
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters(PerfCounters &&) = delete;
+    auto operator=(const PerfCounters &) -> PerfCounters & = delete;
+    auto operator=(PerfCounters &&) -> PerfCounters & = delete;
+
+    [[nodiscard]] auto Available() const -> bool;
+    void Start();
+    auto Stop() -> PerfReading;
+};
+
+auto PerfEventName(PerfEvent event) -> std::string_view;
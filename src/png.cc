@@ -0,0 +1,291 @@
+#include "png.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string_view>
+
+constexpr auto CRC_TABLE = [] {
+    std::array<std::uint32_t, 256> table = {};
+
+    for (std::uint32_t byte = 0; byte < table.size(); ++byte)
+    {
+        std::uint32_t crc = byte;
+
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) != 0 ? 0xedb88320 ^ (crc >> 1) : crc >> 1;
+        }
+
+        table[byte] = crc;
+    }
+
+    return table;
+}();
+
+// RFC 1951 3.2.5: the first length or distance of every code and its number of extra bits
+constexpr std::array<std::uint16_t, 29> LENGTH_BASES = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<std::uint8_t, 29> LENGTH_EXTRA = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                       2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<std::uint16_t, 30> DISTANCE_BASES = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577};
+constexpr std::array<std::uint8_t, 30> DISTANCE_EXTRA = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                         6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+constexpr size_t MIN_MATCH = 3;
+constexpr size_t MAX_MATCH = 258;
+constexpr size_t WINDOW = 32768;
+constexpr int HASH_BITS = 15;
+
+// Deflate packs its bits from the least significant one, but Huffman codes from their most significant bit.
+class DeflateBits
+{
+  private:
+    std::vector<std::uint8_t> &out;
+    std::uint64_t buffer = 0;
+    int count = 0;
+
+  public:
+    explicit DeflateBits(std::vector<std::uint8_t> &out) : out(out)
+    {
+    }
+
+    void Put(const std::uint32_t bits, const int length)
+    {
+        buffer |= std::uint64_t{bits} << count;
+        count += length;
+
+        while (count >= 8)
+        {
+            out.push_back(static_cast<std::uint8_t>(buffer));
+            buffer >>= 8;
+            count -= 8;
+        }
+    }
+
+    void PutCode(const std::uint32_t code, const int length)
+    {
+        // reversed, so that Put emits its first bit first
+        std::uint32_t reversed = 0;
+
+        for (int bit = 0; bit < length; ++bit)
+        {
+            reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+        }
+
+        Put(reversed, length);
+    }
+
+    // the fixed literal/length codes of RFC 1951 3.2.6
+    void PutSymbol(const std::uint32_t symbol)
+    {
+        if (symbol < 144)
+        {
+            PutCode(0x30 + symbol, 8);
+        }
+        else if (symbol < 256)
+        {
+            PutCode(0x190 + symbol - 144, 9);
+        }
+        else if (symbol < 280)
+        {
+            PutCode(symbol - 256, 7);
+        }
+        else
+        {
+            PutCode(0xc0 + symbol - 280, 8);
+        }
+    }
+
+    void PutMatch(const size_t length, const size_t distance)
+    {
+        const auto length_code =
+            static_cast<size_t>(std::ranges::upper_bound(LENGTH_BASES, length) - LENGTH_BASES.begin()) - 1;
+        PutSymbol(static_cast<std::uint32_t>(257 + length_code));
+        Put(static_cast<std::uint32_t>(length - LENGTH_BASES[length_code]), LENGTH_EXTRA[length_code]);
+
+        const auto distance_code =
+            static_cast<size_t>(std::ranges::upper_bound(DISTANCE_BASES, distance) - DISTANCE_BASES.begin()) - 1;
+        PutCode(static_cast<std::uint32_t>(distance_code), 5);
+        Put(static_cast<std::uint32_t>(distance - DISTANCE_BASES[distance_code]), DISTANCE_EXTRA[distance_code]);
+    }
+
+    void Finish()
+    {
+        if (count > 0)
+        {
+            Put(0, 8 - count);
+        }
+    }
+};
+
+auto Crc32(const std::span<const std::uint8_t> bytes, std::uint32_t crc) -> std::uint32_t
+{
+    crc = ~crc;
+
+    for (const auto byte : bytes)
+    {
+        crc = CRC_TABLE[(crc ^ byte) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+auto Adler32(const std::span<const std::uint8_t> bytes) -> std::uint32_t
+{
+    // the largest run whose sums cannot overflow 32 bits before the modulo
+    constexpr size_t RUN = 5552;
+    constexpr std::uint32_t MOD = 65521;
+    std::uint32_t a = 1;
+    std::uint32_t b = 0;
+
+    for (size_t first = 0; first < bytes.size(); first += RUN)
+    {
+        for (const auto byte : bytes.subspan(first, std::min(RUN, bytes.size() - first)))
+        {
+            a += byte;
+            b += a;
+        }
+
+        a %= MOD;
+        b %= MOD;
+    }
+
+    return (b << 16) | a;
+}
+
+void PutBigEndian(std::vector<std::uint8_t> &out, const std::uint32_t value)
+{
+    for (const int shift : {24, 16, 8, 0})
+    {
+        out.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+auto ZlibCompress(const std::span<const std::uint8_t> bytes) -> std::vector<std::uint8_t>
+{
+    std::vector<std::uint8_t> out;
+    out.reserve(bytes.size() / 4 + 64);
+    // deflate with a 32 KB window, no dictionary, fastest level
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    DeflateBits bits(out);
+    // a single final block of fixed codes
+    bits.Put(1, 1);
+    bits.Put(1, 2);
+
+    // the last position of every 3-byte hash, offset by one so that zero means none
+    std::vector<std::uint32_t> heads(size_t{1} << HASH_BITS);
+    const auto hash = [&bytes](const size_t at) {
+        const auto key = std::uint32_t{bytes[at]} | std::uint32_t{bytes[at + 1]} << 8 |
+                         std::uint32_t{bytes[at + 2]} << 16;
+        return (key * 2654435761U) >> (32 - HASH_BITS);
+    };
+
+    size_t at = 0;
+
+    while (at < bytes.size())
+    {
+        size_t length = 0;
+        size_t distance = 0;
+
+        if (at + MIN_MATCH <= bytes.size())
+        {
+            auto &head = heads[hash(at)];
+
+            if (head != 0 && at - (head - 1) <= WINDOW)
+            {
+                const size_t candidate = head - 1;
+                const size_t limit = std::min(MAX_MATCH, bytes.size() - at);
+
+                while (length < limit && bytes[candidate + length] == bytes[at + length])
+                {
+                    ++length;
+                }
+
+                distance = at - candidate;
+            }
+
+            head = static_cast<std::uint32_t>(at + 1);
+        }
+
+        if (length < MIN_MATCH)
+        {
+            bits.PutSymbol(bytes[at]);
+            ++at;
+            continue;
+        }
+
+        bits.PutMatch(length, distance);
+
+        // the positions inside the match feed the hash too, or runs would only ever match their own start
+        for (const size_t end = at + length; ++at < end;)
+        {
+            if (at + MIN_MATCH <= bytes.size())
+            {
+                heads[hash(at)] = static_cast<std::uint32_t>(at + 1);
+            }
+        }
+    }
+
+    bits.PutSymbol(256);
+    bits.Finish();
+
+    PutBigEndian(out, Adler32(bytes));
+    return out;
+}
+
+void PutChunk(std::vector<std::uint8_t> &out, const std::string_view type, const std::span<const std::uint8_t> data)
+{
+    PutBigEndian(out, static_cast<std::uint32_t>(data.size()));
+
+    const auto type_offset = out.size();
+    out.insert(out.end(), type.begin(), type.end());
+    out.insert(out.end(), data.begin(), data.end());
+
+    PutBigEndian(out, Crc32(std::span(out).subspan(type_offset)));
+}
+
+auto EncodePng(const std::span<const std::uint8_t> pixels, const int width, const int height, const size_t pitch)
+    -> std::vector<std::uint8_t>
+{
+    constexpr size_t CHANNELS = 4;
+    const auto row_bytes = static_cast<size_t>(width) * CHANNELS;
+    const auto rows = static_cast<size_t>(height);
+
+    if (width <= 0 || height <= 0 || pitch < row_bytes || pixels.size() < pitch * (rows - 1) + row_bytes)
+    {
+        throw std::invalid_argument("pixels do not cover the image");
+    }
+
+    // a filter byte per row, then the differences with the pixel on the left
+    std::vector<std::uint8_t> filtered;
+    filtered.reserve(rows * (row_bytes + 1));
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const auto line = pixels.subspan(row * pitch, row_bytes);
+        filtered.push_back(1);
+        filtered.insert(filtered.end(), line.begin(), line.begin() + CHANNELS);
+
+        for (size_t i = CHANNELS; i < row_bytes; ++i)
+        {
+            filtered.push_back(static_cast<std::uint8_t>(line[i] - line[i - CHANNELS]));
+        }
+    }
+
+    std::vector<std::uint8_t> header;
+    PutBigEndian(header, static_cast<std::uint32_t>(width));
+    PutBigEndian(header, static_cast<std::uint32_t>(height));
+    // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlacing
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+
+    std::vector<std::uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    PutChunk(png, "IHDR", header);
+    PutChunk(png, "IDAT", ZlibCompress(filtered));
+    PutChunk(png, "IEND", {});
+    return png;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// CRC-32 of PNG chunks (and zip, gzip), continuing from `crc` so that a chunk can be summed piecewise.
+auto Crc32(std::span<const std::uint8_t> bytes, std::uint32_t crc = 0) -> std::uint32_t;
+
+// A zlib stream of `bytes` in a single deflate block of fixed Huffman codes, with greedy LZ77 matches found through
+// a hash of the next three bytes. It compresses less than zlib's dynamic blocks, but the flat colours of rendered
+// frames are mostly long matches, which fixed codes cover well.
+auto ZlibCompress(std::span<const std::uint8_t> bytes) -> std::vector<std::uint8_t>;
+
+// A PNG of 8-bit RGBA pixels whose rows are `pitch` bytes apart. Every row uses the Sub filter: a flat run of one
+// colour becomes zeros, whatever the colour.
+auto EncodePng(std::span<const std::uint8_t> pixels, int width, int height, size_t pitch) -> std::vector<std::uint8_t>;
@@ -0,0 +1,232 @@
+#include "protocol.h"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+#include <vector>
+
+auto SplitWords(const std::string_view line) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> words;
+    size_t start = line.find_first_not_of(" \t\r");
+
+    while (start != std::string_view::npos)
+    {
+        const size_t end = line.find_first_of(" \t\r", start);
+        words.push_back(line.substr(start, end - start));
+        start = line.find_first_not_of(" \t\r", end);
+    }
+
+    return words;
+}
+
+template <typename T> auto ParseNumber(const std::string_view text, const int base) -> T
+{
+    T value = {};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+
+    if (error != std::errc() || end != text.data() + text.size())
+    {
+        throw std::invalid_argument(std::format("invalid number: {}", text));
+    }
+
+    return value;
+}
+
+auto FormatBoard(const Board board) -> std::string
+{
+    return std::format("{:016x}", board);
+}
+
+auto ParseDirection(const char letter) -> Direction
+{
+    switch (letter)
+    {
+    case 'u':
+        return Direction::UP;
+    case 'd':
+        return Direction::DOWN;
+    case 'l':
+        return Direction::LEFT;
+    case 'r':
+        return Direction::RIGHT;
+    default:
+        throw std::invalid_argument(std::format("invalid direction: {}", letter));
+    }
+}
+
+auto DirectionLetter(const Direction dir) -> char
+{
+    constexpr std::string_view letters = "udlr";
+    return letters[static_cast<size_t>(dir)];
+}
+
+auto GameStateName(const GameState state) -> std::string_view
+{
+    switch (state)
+    {
+    case GameState::Startup:
+        return "startup";
+    case GameState::GameOver:
+        return "gameover";
+    case GameState::Playing:
+        return "playing";
+    case GameState::Victory:
+    default:
+        return "victory";
+    }
+}
+
+EngineProtocol::EngineProtocol(const std::uint32_t seed) : game(seed)
+{
+}
+
+auto EngineProtocol::GetGame() -> Game &
+{
+    return game;
+}
+
+auto EngineProtocol::CurrentBoard() -> Board
+{
+    return PackGrid(game.GetGrid());
+}
+
+auto EngineProtocol::StateLine() -> std::string
+{
+    return std::format("state {} {} {}", FormatBoard(CurrentBoard()), game.Score(), GameStateName(game.State()));
+}
+
+auto EngineProtocol::Play(const std::string_view moves) -> std::string
+{
+    std::vector<Direction> directions;
+    directions.reserve(moves.size());
+
+    // validate the whole batch before touching the game
+    for (const char letter : moves)
+    {
+        directions.push_back(ParseDirection(letter));
+    }
+
+    size_t played = 0;
+
+    for (const Direction dir : directions)
+    {
+        if (game.State() != GameState::Playing || !MoveCurrent(dir))
+        {
+            break;
+        }
+
+        game.Update();
+        ++played;
+    }
+
+    return std::format("played {} {} {} {}", played, FormatBoard(CurrentBoard()), game.Score(),
+                       GameStateName(game.State()));
+}
+
+// Moves on the packed board, like `legal` judges moves: two 2^15 tiles do not merge there, so the game never holds a
+// tile the board cannot pack. Returns the score gained, nothing when the move does not change the board.
+auto EngineProtocol::MoveCurrent(const Direction dir) -> std::optional<std::uint32_t>
+{
+    const Board board = CurrentBoard();
+    const auto [after, move_score] = MoveBoard(board, dir);
+
+    if (after == board)
+    {
+        return std::nullopt;
+    }
+
+    Grid moved;
+    UnpackGrid(after, moved);
+    game.Play(moved, move_score);
+    return move_score;
+}
+
+auto EngineProtocol::Execute(const std::string_view line) -> std::string
+{
+    const auto words = SplitWords(line);
+
+    if (words.empty())
+    {
+        throw std::invalid_argument("empty command");
+    }
+
+    const std::string_view command = words[0];
+    const size_t arguments = words.size() - 1;
+
+    if (command == "new" && arguments <= 1)
+    {
+        if (arguments == 1)
+        {
+            game = Game(ParseNumber<std::uint32_t>(words[1], 10));
+        }
+
+        game.Reset();
+        return StateLine();
+    }
+
+    if (command == "position" && (arguments == 1 || arguments == 2))
+    {
+        const auto board = ParseNumber<Board>(words[1], 16);
+        const auto score = arguments == 2 ? ParseNumber<std::uint64_t>(words[2], 10) : 0;
+
+        bool has_moves = false;
+
+        for (const Direction dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            has_moves = has_moves || MoveBoard(board, dir).board != board;
+        }
+
+        Grid grid;
+        UnpackGrid(board, grid);
+        game.Restore(grid, score, std::max(score, game.BestScore()),
+                     has_moves ? GameState::Playing : GameState::GameOver, game.Seed(), game.Endless());
+        return StateLine();
+    }
+
+    if (command == "state" && arguments == 0)
+    {
+        return StateLine();
+    }
+
+    if (command == "legal" && arguments == 0)
+    {
+        const Board board = CurrentBoard();
+        std::string legal = "legal ";
+
+        for (const Direction dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            if (MoveBoard(board, dir).board != board)
+            {
+                legal += DirectionLetter(dir);
+            }
+        }
+
+        return legal.size() == 6 ? legal + "-" : legal;
+    }
+
+    if (command == "move" && arguments == 1 && words[1].size() == 1)
+    {
+        const auto gained = MoveCurrent(ParseDirection(words[1][0]));
+        return gained ? std::format("moved {}", *gained) : "illegal";
+    }
+
+    if (command == "spawn" && arguments == 0)
+    {
+        game.Update();
+        return StateLine();
+    }
+
+    if (command == "play" && arguments == 1)
+    {
+        return Play(words[1]);
+    }
+
+    if (command == "hash" && arguments == 0)
+    {
+        return std::format("hash {}", FormatBoard(Canonicalize(CurrentBoard()).board));
+    }
+
+    throw std::invalid_argument(std::format("invalid command: {}", line));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "board.h"
+#include "game.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Line-oriented protocol that lets external bots drive a Game through pipes. Every command is one line and gets
+// exactly one response line. Boards are written like the tools expect them: 16 hexadecimal exponents, cell (0, 0)
+// last.
+//
+//   new [seed]               starts a new game                         -> state <board> <score> <state>
+//   position <board> [score] replaces the board                        -> state ...
+//   state                                                              -> state ...
+//   legal                    moves that change the board               -> legal <letters among udlr, or ->
+//   move <u|d|l|r>           slides the tiles without spawning         -> moved <gained> | illegal
+//   spawn                    spawns a tile and checks the end of game  -> state ...
+//   play <letters>           move + spawn for every letter, stops at   -> played <count> <board> <score> <state>
+//                            the first illegal move or the end of game
+//   hash                     canonical board, equal for symmetric ones -> hash <board>
+class EngineProtocol
+{
+  private:
+    Game game;
+
+  private:
+    [[nodiscard]] auto CurrentBoard() -> Board;
+    [[nodiscard]] auto StateLine() -> std::string;
+    auto MoveCurrent(Direction dir) -> std::optional<std::uint32_t>;
+    auto Play(std::string_view moves) -> std::string;
+
+  public:
+    explicit EngineProtocol(std::uint32_t seed);
+
+    // Throws std::invalid_argument on unknown commands and malformed arguments, the game is left unchanged.
+    auto Execute(std::string_view line) -> std::string;
+    [[nodiscard]] auto GetGame() -> Game &;
+};
+
+auto ParseDirection(char letter) -> Direction;
+auto DirectionLetter(Direction dir) -> char;
+auto GameStateName(GameState state) -> std::string_view;
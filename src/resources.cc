@@ -0,0 +1,18 @@
+#include "resources.h"
+
+#include <stdexcept>
+
+auto OpenEmbeddedFont(const float size) -> TTF_Font *
+{
+    const auto data = EmbeddedFontData();
+    // the stream only reads the static bytes, closing it frees nothing but the stream
+    SDL_IOStream *stream = SDL_IOFromConstMem(data.data(), data.size());
+    TTF_Font *font = stream ? TTF_OpenFontIO(stream, true, size) : nullptr;
+
+    if (!font)
+    {
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    return font;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <SDL3_ttf/SDL_ttf.h>
+#include <cstdint>
+#include <span>
+
+// the bytes of the font file, compiled into the binary from assets/ by src/CMakeLists.txt
+auto EmbeddedFontData() -> std::span<const std::uint8_t>;
+
+// parses the embedded font without touching the file system; throws std::runtime_error
+auto OpenEmbeddedFont(float size) -> TTF_Font *;
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "board.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <random>
+
+// Rule variants as policy types. A policy decides what the 4-bit codes of a packed board mean:
+//   Value(code)       the tile value, which a merge adds to the score
+//   Merge(a, b)       the code of a merged into b, or 0 when they do not merge
+//   SPAWN_CODES       the codes a spawn can place, with SPAWN_ODDS their probabilities
+//   WIN_CODE          the code that wins the game
+//   BLOCKER           a code that never moves nor merges, 0 for none
+// RuleKernel<Rules> precomputes every row move of a policy at first use, so that each variant plays from its own
+// tables and no rule is looked up while moving.
+
+struct ClassicRules
+{
+    static constexpr std::array<std::uint8_t, 2> SPAWN_CODES = {1, 2};
+    static constexpr std::array SPAWN_ODDS = {PROB_2, PROB_4};
+    static constexpr std::uint8_t WIN_CODE = std::countr_zero(static_cast<unsigned>(WIN_TILE));
+    static constexpr std::uint8_t BLOCKER = 0;
+
+    static constexpr auto Value(const std::uint8_t code) -> std::uint32_t
+    {
+        return code == 0 ? 0 : std::uint32_t{1} << code;
+    }
+
+    // the largest tile has no room to grow
+    static constexpr auto Merge(const std::uint8_t a, const std::uint8_t b) -> std::uint8_t
+    {
+        return a == b && a < MAX_EXPONENT ? static_cast<std::uint8_t>(a + 1) : 0;
+    }
+};
+
+// Tiles are Fibonacci numbers 1, 2, 3, 5, 8... and two neighbours of the sequence merge into the next one.
+struct FibonacciRules
+{
+    static constexpr std::array<std::uint8_t, 2> SPAWN_CODES = {1, 2};
+    static constexpr std::array SPAWN_ODDS = {PROB_2, PROB_4};
+    // 610
+    static constexpr std::uint8_t WIN_CODE = 14;
+    static constexpr std::uint8_t BLOCKER = 0;
+
+    static constexpr auto Value(const std::uint8_t code) -> std::uint32_t
+    {
+        std::uint32_t previous = 1;
+        std::uint32_t value = code == 0 ? 0 : 1;
+
+        for (std::uint8_t i = 1; i < code; ++i)
+        {
+            const auto next = previous + value;
+            previous = value;
+            value = next;
+        }
+
+        return value;
+    }
+
+    static constexpr auto Merge(const std::uint8_t a, const std::uint8_t b) -> std::uint8_t
+    {
+        const bool neighbours = a + 1 == b || b + 1 == a || (a == 1 && b == 1);
+        const auto larger = a > b ? a : b;
+        return a != 0 && b != 0 && neighbours && larger < MAX_EXPONENT ? static_cast<std::uint8_t>(larger + 1) : 0;
+    }
+};
+
+// Threes: a 1 and a 2 make a 3, then equal tiles double: 3, 6, 12...
+struct ThreesRules
+{
+    static constexpr std::array<std::uint8_t, 3> SPAWN_CODES = {1, 2, 3};
+    static constexpr std::array SPAWN_ODDS = {1.0 / 3, 1.0 / 3, 1.0 / 3};
+    // 768
+    static constexpr std::uint8_t WIN_CODE = 11;
+    static constexpr std::uint8_t BLOCKER = 0;
+
+    static constexpr auto Value(const std::uint8_t code) -> std::uint32_t
+    {
+        return code < 3 ? code : std::uint32_t{3} << (code - 3);
+    }
+
+    static constexpr auto Merge(const std::uint8_t a, const std::uint8_t b) -> std::uint8_t
+    {
+        if ((a == 1 && b == 2) || (a == 2 && b == 1))
+        {
+            return 3;
+        }
+
+        return a == b && a >= 3 && a < MAX_EXPONENT ? static_cast<std::uint8_t>(a + 1) : 0;
+    }
+};
+
+// Any policy with `Count` blockers on the starting board: code 15 is a wall that splits its row and column, tiles
+// slide and merge up to it.
+template <typename Rules, int Count = 1> struct WithBlockers : Rules
+{
+    static constexpr std::uint8_t BLOCKER = 15;
+    static constexpr int BLOCKERS = Count;
+
+    static constexpr auto Merge(const std::uint8_t a, const std::uint8_t b) -> std::uint8_t
+    {
+        const std::uint8_t merged = a == BLOCKER || b == BLOCKER ? std::uint8_t{0} : Rules::Merge(a, b);
+        return merged == BLOCKER ? 0 : merged;
+    }
+};
+
+template <typename Rules> class RuleKernel
+{
+  private:
+    struct Tables
+    {
+        std::array<BoardRow, 65536> left = {};
+        std::array<BoardRow, 65536> right = {};
+        // merges need not be symmetric, so a row scores differently in each direction
+        std::array<std::uint32_t, 65536> left_score = {};
+        std::array<std::uint32_t, 65536> right_score = {};
+    };
+
+    // the rules of Game::MoveRow: tiles slide left, and a tile merges at most once per move
+    static auto SlideRowLeft(const BoardRow row, std::uint32_t &score) -> BoardRow
+    {
+        std::array<std::uint8_t, BOARD_SIZE> line = {};
+        size_t write_pos = 0;
+        // tiles never slide past a blocker, or merge across it
+        size_t segment_start = 0;
+        bool last_merged = false;
+
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            const auto code = static_cast<std::uint8_t>((row >> (4 * col)) & 0xf);
+
+            if (code == 0)
+            {
+                continue;
+            }
+
+            if (Rules::BLOCKER != 0 && code == Rules::BLOCKER)
+            {
+                line.at(col) = code;
+                write_pos = col + 1;
+                segment_start = write_pos;
+                last_merged = false;
+                continue;
+            }
+
+            if (write_pos > segment_start && !last_merged)
+            {
+                if (const auto merged = Rules::Merge(line.at(write_pos - 1), code); merged != 0)
+                {
+                    line.at(write_pos - 1) = merged;
+                    score += Rules::Value(merged);
+                    last_merged = true;
+                    continue;
+                }
+            }
+
+            line.at(write_pos++) = code;
+            last_merged = false;
+        }
+
+        BoardRow result = 0;
+
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            result |= static_cast<BoardRow>(line.at(col) << (4 * col));
+        }
+
+        return result;
+    }
+
+    static auto ReverseRow(const BoardRow row) -> BoardRow
+    {
+        return static_cast<BoardRow>((row >> 12) | ((row >> 4) & 0x00f0) | ((row << 4) & 0x0f00) | (row << 12));
+    }
+
+    static auto BuildTables() -> Tables
+    {
+        Tables tables;
+
+        for (size_t row = 0; row < tables.left.size(); ++row)
+        {
+            std::uint32_t score = 0;
+            tables.left.at(row) = SlideRowLeft(static_cast<BoardRow>(row), score);
+            tables.left_score.at(row) = score;
+
+            std::uint32_t reversed_score = 0;
+            tables.right.at(row) = ReverseRow(SlideRowLeft(ReverseRow(static_cast<BoardRow>(row)), reversed_score));
+            tables.right_score.at(row) = reversed_score;
+        }
+
+        return tables;
+    }
+
+    static auto GetTables() -> const Tables &
+    {
+        static const Tables tables = BuildTables();
+        return tables;
+    }
+
+    static auto MoveRows(const Board board, const std::array<BoardRow, 65536> &table,
+                         const std::array<std::uint32_t, 65536> &scores) -> MoveResult
+    {
+        MoveResult result = {0, 0};
+
+        for (size_t row = 0; row < BOARD_SIZE; ++row)
+        {
+            const auto line = GetRow(board, row);
+            result.board |= Board{table[line]} << (16 * row);
+            result.score += scores[line];
+        }
+
+        return result;
+    }
+
+  public:
+    static auto Move(const Board board, const Direction dir) -> MoveResult
+    {
+        const auto &tables = GetTables();
+
+        switch (dir)
+        {
+        case Direction::LEFT:
+            return MoveRows(board, tables.left, tables.left_score);
+        case Direction::RIGHT:
+            return MoveRows(board, tables.right, tables.right_score);
+        case Direction::UP: {
+            auto result = MoveRows(Transpose(board), tables.left, tables.left_score);
+            result.board = Transpose(result.board);
+            return result;
+        }
+        case Direction::DOWN:
+        default: {
+            auto result = MoveRows(Transpose(board), tables.right, tables.right_score);
+            result.board = Transpose(result.board);
+            return result;
+        }
+        }
+    }
+
+    // a random spawn code in a random empty cell, drawing from `gen` in the same order as SpawnRandom
+    template <typename Generator> static auto Spawn(const Board board, Generator &gen) -> Board
+    {
+        const int n_empty = CountEmpty(board);
+
+        if (n_empty == 0)
+        {
+            return board;
+        }
+
+        std::uniform_int_distribution<int> index_dist(0, n_empty - 1);
+        std::discrete_distribution<size_t> code_dist(Rules::SPAWN_ODDS.begin(), Rules::SPAWN_ODDS.end());
+
+        int target = index_dist(gen);
+        const auto code = Rules::SPAWN_CODES.at(code_dist(gen));
+
+        for (size_t i = 0; i < BOARD_CELLS; ++i)
+        {
+            if (GetCell(board, i) == 0 && target-- == 0)
+            {
+                return SetCell(board, i, code);
+            }
+        }
+
+        return board;
+    }
+
+    // the blockers of the policy in random cells, then two spawns
+    template <typename Generator> static auto StartBoard(Generator &gen) -> Board
+    {
+        Board board = 0;
+
+        if constexpr (Rules::BLOCKER != 0)
+        {
+            for (int i = 0; i < Rules::BLOCKERS; ++i)
+            {
+                std::uniform_int_distribution<int> index_dist(0, CountEmpty(board) - 1);
+                int target = index_dist(gen);
+
+                for (size_t cell = 0; cell < BOARD_CELLS; ++cell)
+                {
+                    if (GetCell(board, cell) == 0 && target-- == 0)
+                    {
+                        board = SetCell(board, cell, Rules::BLOCKER);
+                        break;
+                    }
+                }
+            }
+        }
+
+        return Spawn(Spawn(board, gen), gen);
+    }
+
+    static auto HasMoves(const Board board) -> bool
+    {
+        for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            if (Move(board, dir).board != board)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static auto HasWon(const Board board) -> bool
+    {
+        for (size_t i = 0; i < BOARD_CELLS; ++i)
+        {
+            const auto code = GetCell(board, i);
+
+            if (code >= Rules::WIN_CODE && code != Rules::BLOCKER)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
@@ -0,0 +1,390 @@
+#include "search.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr std::array MOVES = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+constexpr std::uint64_t STOP_POLL_MASK = 0xfff;
+// a deadline of a few milliseconds needs a finer poll, which the clock allows: it is far cheaper than the callback
+constexpr std::uint64_t DEADLINE_POLL_MASK = 0xff;
+
+auto EvaluateEmptyCells(const Board board) -> float
+{
+    return static_cast<float>(CountEmpty(board));
+}
+
+// One thread per root move, each with its own searcher, copied from the parent's options once. A search hands them
+// its root moves and waits for all of them, under a generation counter, so that dispatching allocates nothing.
+struct Expectimax::RootPool
+{
+    std::vector<std::unique_ptr<Expectimax>> searchers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    std::span<RootMove> moves;
+    int depth = 0;
+    SearchClock::time_point deadline;
+    std::uint64_t generation = 0;
+    size_t pending = 0;
+    bool stopping = false;
+    std::vector<std::jthread> threads;
+
+    explicit RootPool(const SearchOptions &options);
+    ~RootPool();
+
+    RootPool(const RootPool &) = delete;
+    RootPool(RootPool &&) = delete;
+    auto operator=(const RootPool &) -> RootPool & = delete;
+    auto operator=(RootPool &&) -> RootPool & = delete;
+
+    void Run(size_t index);
+    void Search(std::span<RootMove> root_moves, int search_depth, SearchClock::time_point search_deadline);
+};
+
+Expectimax::RootPool::RootPool(const SearchOptions &options)
+{
+    auto searcher_options = options;
+    searcher_options.threads = 1;
+
+    for (size_t i = 0; i < MOVES.size(); ++i)
+    {
+        searchers.push_back(std::make_unique<Expectimax>(searcher_options));
+    }
+
+    for (size_t i = 0; i < MOVES.size(); ++i)
+    {
+        threads.emplace_back([this, i] { Run(i); });
+    }
+}
+
+Expectimax::RootPool::~RootPool()
+{
+    {
+        const std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    start_cv.notify_all();
+    threads.clear();
+}
+
+void Expectimax::RootPool::Run(const size_t index)
+{
+    auto &searcher = *searchers[index];
+    std::uint64_t seen = 0;
+    std::unique_lock lock(mutex);
+
+    while (true)
+    {
+        start_cv.wait(lock, [&] { return stopping || generation != seen; });
+
+        if (stopping)
+        {
+            return;
+        }
+
+        seen = generation;
+
+        // fewer legal moves than threads
+        if (index >= moves.size())
+        {
+            continue;
+        }
+
+        auto &root = moves[index];
+        const int search_depth = depth;
+        searcher.nodes = 0;
+        searcher.aborted = false;
+        searcher.timed_out = false;
+        searcher.deadline = deadline;
+        lock.unlock();
+
+        root.value = searcher.ChanceNode(root.board, search_depth);
+        root.nodes = searcher.nodes;
+        root.aborted = searcher.aborted;
+        root.timed_out = searcher.timed_out;
+
+        lock.lock();
+
+        if (--pending == 0)
+        {
+            done_cv.notify_one();
+        }
+    }
+}
+
+void Expectimax::RootPool::Search(const std::span<RootMove> root_moves, const int search_depth,
+                                  const SearchClock::time_point search_deadline)
+{
+    std::unique_lock lock(mutex);
+    moves = root_moves;
+    depth = search_depth;
+    deadline = search_deadline;
+    pending = root_moves.size();
+    ++generation;
+    start_cv.notify_all();
+    done_cv.wait(lock, [&] { return pending == 0; });
+}
+
+Expectimax::Expectimax(SearchOptions options) : options(std::move(options))
+{
+}
+
+Expectimax::~Expectimax() = default;
+Expectimax::Expectimax(Expectimax &&) noexcept = default;
+auto Expectimax::operator=(Expectimax &&) noexcept -> Expectimax & = default;
+
+auto TimeBudget(const Board board, const std::chrono::microseconds limit) -> std::chrono::microseconds
+{
+    // an open board with small tiles forgives a shallow move, a crowded one holding a large tile does not
+    const double crowding = 1.0 - static_cast<double>(CountEmpty(board)) / BOARD_CELLS;
+    const double tile = std::min<double>(MaxExponent(board), 11) / 11;
+    const double share = std::min(0.25 + 0.5 * crowding + 0.25 * tile, 1.0);
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(limit * share);
+}
+
+auto Expectimax::BestMove(const Board board) -> SearchResult
+{
+    nodes = 0;
+    aborted = false;
+    timed_out = false;
+
+    if (options.table != nullptr)
+    {
+        options.table->NewSearch();
+    }
+
+    // the root moves and their results are the only temporaries of a search, and like those of the nodes below they
+    // live on the stack
+    std::array<RootMove, MOVES.size()> moves;
+    size_t n_moves = 0;
+
+    for (const auto dir : MOVES)
+    {
+        const Board after = MoveBoard(board, dir).board;
+
+        if (after != board)
+        {
+            moves[n_moves++] = {dir, after};
+        }
+    }
+
+    auto root_moves = std::span(moves).first(n_moves);
+    SearchResult result;
+
+    if (options.time_budget.count() <= 0)
+    {
+        deadline = SearchClock::time_point::max();
+        SearchRoot(root_moves, options.depth);
+        result = PickBest(root_moves);
+        result.depth = aborted ? 0 : options.depth;
+    }
+    else
+    {
+        // the first evaluation builds the tables of the evaluator, which must not eat into the deadline
+        (void)options.evaluate(board);
+        deadline = SearchClock::now() + TimeBudget(board, options.time_budget);
+
+        for (int depth = 1; depth <= options.depth && !root_moves.empty(); ++depth)
+        {
+            SearchRoot(root_moves, depth);
+
+            // a partial iteration has only searched some of the moves, its best one means nothing
+            if (aborted)
+            {
+                break;
+            }
+
+            result = PickBest(root_moves);
+            result.depth = depth;
+
+            // the next iteration starts with the best moves of this one, and fills the table from them first
+            // an insertion sort, stable without the buffer std::stable_sort allocates
+            for (size_t i = 1; i < root_moves.size(); ++i)
+            {
+                const auto first = std::ranges::upper_bound(root_moves.first(i), root_moves[i].value,
+                                                            std::ranges::greater{}, &RootMove::value);
+                std::rotate(first, root_moves.begin() + static_cast<std::ptrdiff_t>(i),
+                            root_moves.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+            }
+        }
+
+        // running out of time before depth 1 completes still has to answer with a legal move
+        if (result.depth == 0 && !root_moves.empty())
+        {
+            result.move = root_moves.front().dir;
+        }
+    }
+
+    result.nodes = nodes;
+    // only the deadline may cut a deepening search short, once it has completed an iteration
+    result.aborted = aborted && !(timed_out && result.depth > 0);
+    return result;
+}
+
+void Expectimax::SearchRoot(const std::span<RootMove> root_moves, const int depth)
+{
+    if (options.threads > 1 && root_moves.size() > 1)
+    {
+        // one searcher per root move, sharing the transposition table
+        if (!pool)
+        {
+            pool = std::make_unique<RootPool>(options);
+        }
+
+        pool->Search(root_moves, depth, deadline);
+
+        for (const auto &root : root_moves)
+        {
+            nodes += root.nodes;
+            aborted = aborted || root.aborted;
+            timed_out = timed_out || root.timed_out;
+        }
+    }
+    else
+    {
+        for (auto &root : root_moves)
+        {
+            root.value = ChanceNode(root.board, depth);
+        }
+    }
+}
+
+auto Expectimax::PickBest(const std::span<const RootMove> root_moves) -> SearchResult
+{
+    SearchResult result;
+
+    for (const auto &root : root_moves)
+    {
+        if (!result.move || root.value > result.value)
+        {
+            result.move = root.dir;
+            result.value = root.value;
+        }
+    }
+
+    return result;
+}
+
+auto Expectimax::Stopped() -> bool
+{
+    // polling the callback on every node would cost more than the node itself
+    if (!aborted && deadline != SearchClock::time_point::max() && (nodes & DEADLINE_POLL_MASK) == 0)
+    {
+        timed_out = SearchClock::now() >= deadline;
+        aborted = timed_out;
+    }
+
+    if (!aborted && options.should_stop && (nodes & STOP_POLL_MASK) == 0)
+    {
+        aborted = options.should_stop();
+    }
+
+    return aborted;
+}
+
+auto Expectimax::MaxNode(const Board board, const int depth) -> float
+{
+    ++nodes;
+
+    if (Stopped())
+    {
+        return 0;
+    }
+
+    if (options.tablebase != nullptr)
+    {
+        if (const auto probability = options.tablebase->Probe(board))
+        {
+            return *probability * options.tablebase_scale;
+        }
+    }
+
+    if (depth <= 0)
+    {
+        return options.evaluate(board);
+    }
+
+    CanonicalBoard canonical = {board, 0};
+    auto order = MOVES;
+
+    if (options.table != nullptr)
+    {
+        canonical = Canonicalize(board);
+
+        if (const auto entry = options.table->Probe(canonical.board))
+        {
+            if (entry->depth >= depth)
+            {
+                return entry->value;
+            }
+
+            // a shallower search of this board found its best move first, it is likely the best again
+            if (entry->move)
+            {
+                const auto first = std::ranges::find(order, InvertSymmetry(*entry->move, canonical.symmetry));
+                std::rotate(order.begin(), first, first + 1);
+            }
+        }
+    }
+
+    float best = 0;
+    std::optional<Direction> best_move;
+
+    for (const auto dir : order)
+    {
+        const Board after = MoveBoard(board, dir).board;
+
+        if (after == board)
+        {
+            continue;
+        }
+
+        const float value = ChanceNode(after, depth);
+
+        if (!best_move || value > best)
+        {
+            best = value;
+            best_move = dir;
+        }
+    }
+
+    // an aborted subtree has no meaningful value
+    if (options.table != nullptr && !aborted)
+    {
+        // moves are stored in the orientation of the canonical board
+        const auto stored_move = best_move ? std::optional(ApplySymmetry(*best_move, canonical.symmetry)) : std::nullopt;
+        options.table->Store(canonical.board, depth, best, stored_move);
+    }
+
+    return best;
+}
+
+auto Expectimax::ChanceNode(const Board board, const int depth) -> float
+{
+    ++nodes;
+
+    float total = 0;
+    int n_empty = 0;
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        if (GetCell(board, i) != 0)
+        {
+            continue;
+        }
+
+        total += static_cast<float>(PROB_2) * MaxNode(SetCell(board, i, 1), depth - 1) +
+                 static_cast<float>(PROB_4) * MaxNode(SetCell(board, i, 2), depth - 1);
+        ++n_empty;
+    }
+
+    return n_empty == 0 ? 0 : total / static_cast<float>(n_empty);
+}
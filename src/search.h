@@ -0,0 +1,105 @@
+#pragma once
+
+#include "board.h"
+#include "heuristic.h"
+#include "tablebase.h"
+#include "transposition_table.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+
+using Evaluator = std::function<float(Board)>;
+using SearchClock = std::chrono::steady_clock;
+
+// Version of the values Expectimax stores in transposition tables. Bumped whenever they change meaning (default
+// evaluator, weights, tablebase scale), so that table files written by older builds are refused.
+constexpr std::uint64_t SEARCH_VALUES_VERSION = 1;
+
+auto EvaluateEmptyCells(Board board) -> float;
+
+struct SearchOptions
+{
+    // the depth searched, or the deepest iteration when time_budget is set
+    int depth = 2;
+    Evaluator evaluate = EvaluateHeuristic;
+    const Tablebase *tablebase = nullptr;
+    // value of a certain tablebase win, in evaluator units: above any board of the default heuristic
+    float tablebase_scale = 4e6f;
+    // shared cache of max node results, keyed on canonical boards
+    TranspositionTable *table = nullptr;
+    // polled every few thousand nodes, the search gives up as soon as it returns true
+    std::function<bool()> should_stop;
+    // root moves are searched in parallel when greater than 1
+    unsigned threads = 1;
+    // When positive, the search deepens from depth 1 and answers with the deepest iteration completed before the
+    // TimeBudget of the board runs out, which never exceeds this limit.
+    std::chrono::microseconds time_budget{0};
+};
+
+struct SearchResult
+{
+    std::optional<Direction> move;
+    float value = 0;
+    std::uint64_t nodes = 0;
+    // deepest completed search, 0 when none completed
+    int depth = 0;
+    // the search was stopped early, move and value are not reliable
+    bool aborted = false;
+};
+
+// The share of `limit` that a board deserves: a quarter for an open board of small tiles, all of it for a full board
+// holding a 2048.
+auto TimeBudget(Board board, std::chrono::microseconds limit) -> std::chrono::microseconds;
+
+// Expectimax over packed boards: the player maximizes, spawns are averaged with PROB_2 / PROB_4.
+// Positions covered by the tablebase are exact and are not searched any further, and positions already searched
+// as deep in any orientation are read back from the transposition table, and the moves of shallower searches are
+// tried first.
+class Expectimax
+{
+  private:
+    struct RootMove
+    {
+        Direction dir = Direction::UP;
+        Board board = 0;
+        float value = 0;
+        std::uint64_t nodes = 0;
+        bool aborted = false;
+        bool timed_out = false;
+    };
+
+    // the threads of the parallel root search, started by the first one and kept for every later search
+    struct RootPool;
+
+    SearchOptions options;
+    std::unique_ptr<RootPool> pool;
+    std::uint64_t nodes = 0;
+    bool aborted = false;
+    // the stop came from the deadline rather than from should_stop
+    bool timed_out = false;
+    SearchClock::time_point deadline = SearchClock::time_point::max();
+
+  private:
+    void SearchRoot(std::span<RootMove> root_moves, int depth);
+    static auto PickBest(std::span<const RootMove> root_moves) -> SearchResult;
+    auto Stopped() -> bool;
+    auto MaxNode(Board board, int depth) -> float;
+    auto ChanceNode(Board board, int depth) -> float;
+
+  public:
+    explicit Expectimax(SearchOptions options);
+    ~Expectimax();
+
+    Expectimax(const Expectimax &) = delete;
+    Expectimax(Expectimax &&) noexcept;
+    auto operator=(const Expectimax &) -> Expectimax & = delete;
+    auto operator=(Expectimax &&) noexcept -> Expectimax &;
+
+    // Allocates nothing once a first search has started the threads, so a searcher kept for many moves does all of
+    // its allocations up front.
+    auto BestMove(Board board) -> SearchResult;
+};
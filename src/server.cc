@@ -0,0 +1,513 @@
+#include "server.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr int MAX_EVENTS = 128;
+
+auto SystemError(const std::string &what) -> std::runtime_error
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// 0 when something accepts a connection on `address`, the errno of the failed connect otherwise
+auto ConnectError(const sockaddr_un &address) -> int
+{
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (fd < 0)
+    {
+        return errno;
+    }
+
+    const int error = connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0 ? 0 : errno;
+    close(fd);
+    return error;
+}
+
+class Reactor
+{
+  private:
+    struct Connection
+    {
+        std::vector<std::byte> input;
+        std::vector<std::byte> output;
+        size_t output_sent = 0;
+        // waiting for EPOLLOUT instead of EPOLLIN
+        bool writing = false;
+        std::vector<std::uint32_t> sessions;
+    };
+
+    struct HostedGame
+    {
+        CompactGame game;
+        // only the connection that created a game may play it
+        int owner;
+    };
+
+    int listen_fd;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::uint32_t shard;
+    std::uint32_t shards;
+    SessionIds session_ids;
+    std::unordered_map<std::uint32_t, HostedGame> games;
+    std::unordered_map<int, Connection> connections;
+    std::atomic<size_t> n_sessions = 0;
+
+  private:
+    void Accept();
+    void Read(int fd, Connection &connection);
+    void Flush(int fd, Connection &connection);
+    void Close(int fd);
+    auto Handle(int fd, Connection &connection, const ServerRequest &request) -> ServerReply;
+
+  public:
+    Reactor(int listen_fd, std::uint32_t shard, std::uint32_t shards);
+    ~Reactor();
+
+    Reactor(const Reactor &) = delete;
+    Reactor(Reactor &&) = delete;
+    auto operator=(const Reactor &) -> Reactor & = delete;
+    auto operator=(Reactor &&) -> Reactor & = delete;
+
+    void Run();
+    void Wake() const;
+    [[nodiscard]] auto Sessions() const -> size_t;
+};
+
+SessionIds::SessionIds(const std::uint32_t shard, const std::uint32_t shards, const std::uint32_t first_slot)
+    : shard(shard), shards(shards), last_slot((std::numeric_limits<std::uint32_t>::max() - shard) / shards),
+      next_slot(first_slot)
+{
+}
+
+Reactor::Reactor(const int listen_fd, const std::uint32_t shard, const std::uint32_t shards)
+    : listen_fd(listen_fd), shard(shard), shards(shards), session_ids(shard, shards)
+{
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (epoll_fd < 0 || wake_fd < 0)
+    {
+        throw SystemError("unable to create the event loop");
+    }
+
+    epoll_event wake = {.events = EPOLLIN, .data = {.fd = wake_fd}};
+    // every reactor waits on the listening socket, EPOLLEXCLUSIVE wakes only one of them per connection
+    epoll_event listen = {.events = EPOLLIN | EPOLLEXCLUSIVE, .data = {.fd = listen_fd}};
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake) != 0 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen) != 0)
+    {
+        throw SystemError("unable to register the sockets");
+    }
+}
+
+Reactor::~Reactor()
+{
+    for (const auto &[fd, _connection] : connections)
+    {
+        close(fd);
+    }
+
+    close(wake_fd);
+    close(epoll_fd);
+}
+
+void Reactor::Wake() const
+{
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto written = write(wake_fd, &one, sizeof(one));
+}
+
+auto Reactor::Sessions() const -> size_t
+{
+    return n_sessions.load(std::memory_order_relaxed);
+}
+
+void Reactor::Run()
+{
+    std::array<epoll_event, MAX_EVENTS> events = {};
+
+    while (true)
+    {
+        const int ready = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, -1);
+
+        if (ready < 0 && errno != EINTR)
+        {
+            return;
+        }
+
+        for (int i = 0; i < ready; ++i)
+        {
+            const int fd = events[i].data.fd;
+
+            if (fd == wake_fd)
+            {
+                return;
+            }
+
+            if (fd == listen_fd)
+            {
+                Accept();
+                continue;
+            }
+
+            const auto found = connections.find(fd);
+
+            if (found == connections.end())
+            {
+                continue;
+            }
+
+            if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0 && (events[i].events & EPOLLIN) == 0)
+            {
+                Close(fd);
+            }
+            else if ((events[i].events & EPOLLOUT) != 0)
+            {
+                Flush(fd, found->second);
+            }
+            else
+            {
+                Read(fd, found->second);
+            }
+        }
+    }
+}
+
+void Reactor::Accept()
+{
+    while (true)
+    {
+        const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        // another reactor may have taken the connection first
+        if (fd < 0)
+        {
+            return;
+        }
+
+        epoll_event event = {.events = EPOLLIN, .data = {.fd = fd}};
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        connections.emplace(fd, Connection());
+    }
+}
+
+void Reactor::Read(const int fd, Connection &connection)
+{
+    auto &input = connection.input;
+    const size_t kept = input.size();
+    input.resize(kept + READ_CHUNK);
+
+    const auto received = recv(fd, input.data() + kept, READ_CHUNK, 0);
+
+    if (received <= 0)
+    {
+        input.resize(kept);
+
+        if (received == 0 || (errno != EAGAIN && errno != EINTR))
+        {
+            Close(fd);
+        }
+
+        return;
+    }
+
+    input.resize(kept + static_cast<size_t>(received));
+
+    const size_t frames = input.size() / sizeof(ServerRequest);
+    connection.output.reserve(connection.output.size() + frames * sizeof(ServerReply));
+
+    for (size_t i = 0; i < frames; ++i)
+    {
+        ServerRequest request = {};
+        std::memcpy(&request, input.data() + i * sizeof(ServerRequest), sizeof(request));
+
+        const ServerReply reply = Handle(fd, connection, request);
+        const auto *bytes = reinterpret_cast<const std::byte *>(&reply);
+        connection.output.insert(connection.output.end(), bytes, bytes + sizeof(reply));
+    }
+
+    // keep the partial frame for the next read
+    input.erase(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(frames * sizeof(ServerRequest)));
+    Flush(fd, connection);
+}
+
+void Reactor::Flush(const int fd, Connection &connection)
+{
+    auto &output = connection.output;
+
+    while (connection.output_sent < output.size())
+    {
+        const auto sent = send(fd, output.data() + connection.output_sent, output.size() - connection.output_sent,
+                               MSG_NOSIGNAL);
+
+        if (sent < 0)
+        {
+            if (errno == EAGAIN)
+            {
+                break;
+            }
+
+            Close(fd);
+            return;
+        }
+
+        connection.output_sent += static_cast<size_t>(sent);
+    }
+
+    const bool pending = connection.output_sent < output.size();
+
+    if (!pending)
+    {
+        output.clear();
+        connection.output_sent = 0;
+    }
+
+    if (pending == connection.writing)
+    {
+        return;
+    }
+
+    // a client that does not read its replies stops being read from until they are delivered
+    connection.writing = pending;
+    epoll_event event = {.events = pending ? static_cast<std::uint32_t>(EPOLLOUT) : static_cast<std::uint32_t>(EPOLLIN),
+                         .data = {.fd = fd}};
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+}
+
+void Reactor::Close(const int fd)
+{
+    const auto found = connections.find(fd);
+
+    if (found == connections.end())
+    {
+        return;
+    }
+
+    for (const std::uint32_t session : found->second.sessions)
+    {
+        games.erase(session);
+    }
+
+    n_sessions.store(games.size(), std::memory_order_relaxed);
+    connections.erase(found);
+    close(fd);
+}
+
+auto Reactor::Handle(const int fd, Connection &connection, const ServerRequest &request) -> ServerReply
+{
+    ServerReply reply = {};
+    reply.session = request.session;
+
+    if (request.command == ServerCommand::NewGame)
+    {
+        // ids of this shard are congruent to it, so the id alone tells which reactor hosts a game
+        const std::uint32_t session = session_ids.Next([this](const std::uint32_t id) { return games.contains(id); });
+        auto &hosted = games.emplace(session, HostedGame{CompactGame(request.session), fd}).first->second;
+        hosted.game.Start();
+        connection.sessions.push_back(session);
+        n_sessions.store(games.size(), std::memory_order_relaxed);
+
+        reply.session = session;
+        reply.board = hosted.game.GetBoard();
+        reply.state = hosted.game.State();
+        return reply;
+    }
+
+    const auto found = games.find(request.session);
+
+    if (found == games.end() || found->second.owner != fd)
+    {
+        reply.status = ServerStatus::UnknownSession;
+        return reply;
+    }
+
+    auto &game = found->second.game;
+
+    switch (request.command)
+    {
+    case ServerCommand::Move:
+        if (static_cast<std::uint8_t>(request.direction) > static_cast<std::uint8_t>(Direction::RIGHT))
+        {
+            reply.status = ServerStatus::BadRequest;
+        }
+        else if (!game.Move(request.direction))
+        {
+            reply.status = ServerStatus::Illegal;
+        }
+        break;
+    case ServerCommand::State:
+        break;
+    case ServerCommand::Close:
+        std::erase(connection.sessions, request.session);
+        reply.board = game.GetBoard();
+        reply.score = game.Score();
+        reply.state = game.State();
+        games.erase(found);
+        n_sessions.store(games.size(), std::memory_order_relaxed);
+        return reply;
+    default:
+        reply.status = ServerStatus::BadRequest;
+        return reply;
+    }
+
+    reply.board = game.GetBoard();
+    reply.score = game.Score();
+    reply.state = game.State();
+    return reply;
+}
+
+Server::Server(const ServerOptions &options) : socket_path(options.socket_path)
+{
+    if (!socket_path.empty())
+    {
+        sockaddr_un address = {.sun_family = AF_UNIX, .sun_path = {}};
+        const std::string path = socket_path.string();
+
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error("socket path too long: " + path);
+        }
+
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        // a socket nobody listens on is left behind by a server that did not shut down cleanly, one that answers
+        // belongs to a live server, and anything else at the path is not ours to remove
+        if (std::filesystem::is_socket(socket_path))
+        {
+            const int error = ConnectError(address);
+
+            if (error == 0)
+            {
+                Stop();
+                throw std::runtime_error("another server listens on " + path);
+            }
+
+            if (error == ECONNREFUSED)
+            {
+                unlink(path.c_str());
+            }
+        }
+
+        if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+        {
+            Stop();
+            throw SystemError("unable to bind " + path);
+        }
+
+        bound_path = true;
+    }
+    else
+    {
+        sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(options.port), .sin_addr = {}, .sin_zero = {}};
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        const int reuse = 1;
+        socklen_t length = sizeof(address);
+
+        if (listen_fd < 0 || setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+        {
+            Stop();
+            throw SystemError("unable to bind port " + std::to_string(options.port));
+        }
+
+        port = ntohs(address.sin_port);
+    }
+
+    if (listen(listen_fd, SOMAXCONN) != 0)
+    {
+        Stop();
+        throw SystemError("unable to listen");
+    }
+
+    const auto shards = std::max(options.reactors, 1U);
+
+    try
+    {
+        for (std::uint32_t shard = 0; shard < shards; ++shard)
+        {
+            reactors.push_back(std::make_unique<Reactor>(listen_fd, shard, shards));
+        }
+    }
+    catch (...)
+    {
+        Stop();
+        throw;
+    }
+
+    for (const auto &reactor : reactors)
+    {
+        threads.emplace_back(&Reactor::Run, reactor.get());
+    }
+}
+
+Server::~Server()
+{
+    Stop();
+}
+
+void Server::Stop()
+{
+    for (const auto &reactor : reactors)
+    {
+        reactor->Wake();
+    }
+
+    threads.clear();
+    reactors.clear();
+
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        listen_fd = -1;
+
+        if (bound_path)
+        {
+            unlink(socket_path.c_str());
+            bound_path = false;
+        }
+    }
+}
+
+auto Server::Port() const -> std::uint16_t
+{
+    return port;
+}
+
+auto Server::Sessions() const -> size_t
+{
+    size_t total = 0;
+
+    for (const auto &reactor : reactors)
+    {
+        total += reactor->Sessions();
+    }
+
+    return total;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "compact_game.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+enum class ServerCommand : std::uint8_t
+{
+    NewGame,
+    Move,
+    State,
+    Close,
+};
+
+enum class ServerStatus : std::uint8_t
+{
+    Ok,
+    // the move changes nothing or the game is over
+    Illegal,
+    UnknownSession,
+    BadRequest,
+};
+
+// Fixed-size frames in native byte order, the server only listens locally. Clients may pipeline any number of
+// requests on one connection, every request gets exactly one reply, in order.
+struct ServerRequest
+{
+    // seed of the new game for NewGame
+    std::uint32_t session;
+    ServerCommand command;
+    // Move only
+    Direction direction;
+    std::uint16_t reserved;
+};
+
+struct ServerReply
+{
+    Board board;
+    std::uint32_t session;
+    std::uint32_t score;
+    ServerStatus status;
+    GameState state;
+    std::array<std::uint8_t, 6> reserved;
+};
+
+static_assert(sizeof(ServerRequest) == 8);
+static_assert(sizeof(ServerReply) == 24);
+
+struct ServerOptions
+{
+    // a Unix-domain socket when set, loopback TCP on `port` otherwise (0 picks a free port)
+    std::filesystem::path socket_path;
+    std::uint16_t port = 0;
+    unsigned reactors = 1;
+};
+
+// Hands out the game ids of one reactor: congruent to its shard modulo the number of reactors, so that the id alone
+// names the reactor. A long-running server wraps around the 32-bit ids, after which the ones still in play are skipped.
+class SessionIds
+{
+  private:
+    std::uint32_t shard;
+    std::uint32_t shards;
+    // the last slot whose id fits in 32 bits
+    std::uint32_t last_slot;
+    std::uint32_t next_slot;
+
+  public:
+    // slot 0 is never used, so that no game of shard 0 gets the id 0
+    SessionIds(std::uint32_t shard, std::uint32_t shards, std::uint32_t first_slot = 1);
+
+    // the next id for which `live(id)` is false
+    template <typename Live> auto Next(const Live &live) -> std::uint32_t
+    {
+        while (true)
+        {
+            const std::uint32_t id = next_slot * shards + shard;
+            next_slot = next_slot == last_slot ? 1 : next_slot + 1;
+
+            if (!live(id))
+            {
+                return id;
+            }
+        }
+    }
+};
+
+class Reactor;
+
+// Hosts independent games for many local clients. Every reactor thread runs its own epoll loop over the
+// connections it accepted and owns a shard of the games: session ids are allocated so that `id % reactors` names
+// the reactor, and games never move between threads, so no game is ever locked. A game lives as long as the
+// connection that created it.
+class Server
+{
+  private:
+    int listen_fd = -1;
+    std::filesystem::path socket_path;
+    // the socket file at `socket_path` is this server's, and goes away with it
+    bool bound_path = false;
+    std::uint16_t port = 0;
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    std::vector<std::jthread> threads;
+
+  public:
+    // Binds the socket and starts the reactors, throws std::runtime_error when the socket cannot be set up.
+    explicit Server(const ServerOptions &options);
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server(Server &&) = delete;
+    auto operator=(const Server &) -> Server & = delete;
+    auto operator=(Server &&) -> Server & = delete;
+
+    void Stop();
+    [[nodiscard]] auto Port() const -> std::uint16_t;
+    [[nodiscard]] auto Sessions() const -> size_t;
+};
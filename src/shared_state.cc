@@ -0,0 +1,277 @@
+#include "shared_state.h"
+
+#include <atomic>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define C2048_HAS_SHM 1
+#endif
+
+constexpr std::array<char, 8> STATE_MAGIC = {'C', '2', '0', '4', '8', 'G', 'S', '\0'};
+// version 2 adds the writer's pid
+constexpr std::uint32_t STATE_VERSION = 2;
+
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free);
+
+auto TakeSnapshot(Game &game) -> GameSnapshot
+{
+    GameSnapshot snapshot;
+    const auto &grid = game.GetGrid();
+
+    for (size_t row = 0; row < grid.Rows(); ++row)
+    {
+        for (size_t col = 0; col < grid.Cols(); ++col)
+        {
+            snapshot.tiles.at(row * grid.Cols() + col) = static_cast<std::uint32_t>(grid.GetTile(row, col).value);
+        }
+    }
+
+    snapshot.score = game.Score();
+    snapshot.best_score = game.BestScore();
+    snapshot.moves = game.Moves();
+    snapshot.state = game.State();
+    return snapshot;
+}
+
+auto EncodeSnapshot(const GameSnapshot &snapshot) -> std::array<std::uint64_t, SNAPSHOT_WORDS>
+{
+    std::array<std::uint64_t, SNAPSHOT_WORDS> words = {};
+
+    for (size_t i = 0; i < GRID_TILES / 2; ++i)
+    {
+        words[i] = std::uint64_t{snapshot.tiles[2 * i]} | std::uint64_t{snapshot.tiles[2 * i + 1]} << 32;
+    }
+
+    words[GRID_TILES / 2] = snapshot.score;
+    words[GRID_TILES / 2 + 1] = snapshot.best_score;
+    words[GRID_TILES / 2 + 2] = snapshot.moves;
+    words[GRID_TILES / 2 + 3] = static_cast<std::uint64_t>(snapshot.state);
+    return words;
+}
+
+auto DecodeSnapshot(const std::array<std::uint64_t, SNAPSHOT_WORDS> &words) -> GameSnapshot
+{
+    GameSnapshot snapshot;
+
+    for (size_t i = 0; i < GRID_TILES / 2; ++i)
+    {
+        snapshot.tiles[2 * i] = static_cast<std::uint32_t>(words[i]);
+        snapshot.tiles[2 * i + 1] = static_cast<std::uint32_t>(words[i] >> 32);
+    }
+
+    snapshot.score = words[GRID_TILES / 2];
+    snapshot.best_score = words[GRID_TILES / 2 + 1];
+    snapshot.moves = words[GRID_TILES / 2 + 2];
+    snapshot.state = static_cast<GameState>(words[GRID_TILES / 2 + 3]);
+    return snapshot;
+}
+
+// shm_open wants a single leading slash
+auto SharedObjectName(const std::string &name) -> std::string
+{
+    return name.starts_with('/') ? name : "/" + name;
+}
+
+#ifdef C2048_HAS_SHM
+auto MapSegment(const int fd, const int protection) -> SharedStateSegment *
+{
+    void *mapping = mmap(nullptr, sizeof(SharedStateSegment), protection, MAP_SHARED, fd, 0);
+    close(fd);
+    return mapping == MAP_FAILED ? nullptr : static_cast<SharedStateSegment *>(mapping);
+}
+#endif
+
+#ifdef C2048_HAS_SHM
+// Whether the object was left by a publisher that is gone, or never completed by one. A publisher still between
+// shm_open and its magic looks like the latter: two games starting under one name at the same instant may collide.
+auto IsStaleSegment(const std::string &name) -> bool
+{
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+
+    if (fd < 0)
+    {
+        return errno == ENOENT;
+    }
+
+    struct stat info = {};
+
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedStateSegment))
+    {
+        close(fd);
+        return true;
+    }
+
+    auto *segment = MapSegment(fd, PROT_READ);
+
+    if (!segment)
+    {
+        return false;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const bool stale = segment->magic != STATE_MAGIC || segment->version != STATE_VERSION ||
+                       (kill(segment->writer_pid, 0) != 0 && errno == ESRCH);
+    munmap(segment, sizeof(SharedStateSegment));
+    return stale;
+}
+#endif
+
+StatePublisher::StatePublisher(const std::string &name) : name(SharedObjectName(name))
+{
+#ifdef C2048_HAS_SHM
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+
+    // only the object of a crashed run is taken over, a live writer keeps its name
+    if (fd < 0 && errno == EEXIST && IsStaleSegment(this->name))
+    {
+        shm_unlink(this->name.c_str());
+        fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+
+    if (fd < 0)
+    {
+        throw std::runtime_error(errno == EEXIST ? "another process publishes as " + this->name
+                                                 : "unable to create the shared memory object " + this->name);
+    }
+
+    if (ftruncate(fd, sizeof(SharedStateSegment)) != 0)
+    {
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw std::runtime_error("unable to size the shared memory object " + this->name);
+    }
+
+    segment = MapSegment(fd, PROT_READ | PROT_WRITE);
+
+    if (!segment)
+    {
+        shm_unlink(this->name.c_str());
+        throw std::runtime_error("unable to map the shared memory object " + this->name);
+    }
+
+    // viewers check the magic last, once the rest is in place
+    segment->version = STATE_VERSION;
+    segment->words = SNAPSHOT_WORDS;
+    segment->writer_pid = getpid();
+    std::atomic_ref(segment->sequence).store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    segment->magic = STATE_MAGIC;
+#else
+    throw std::runtime_error("shared memory publishing needs a POSIX system");
+#endif
+}
+
+StatePublisher::~StatePublisher()
+{
+#ifdef C2048_HAS_SHM
+    munmap(segment, sizeof(SharedStateSegment));
+    shm_unlink(name.c_str());
+#endif
+}
+
+void StatePublisher::Publish(const GameSnapshot &snapshot)
+{
+    const auto words = EncodeSnapshot(snapshot);
+    std::atomic_ref sequence(segment->sequence);
+    // the only writer, so nothing else changes the sequence
+    const auto start = sequence.load(std::memory_order_relaxed);
+
+    sequence.store(start + 1, std::memory_order_relaxed);
+    // the odd sequence is visible before any of the new payload
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+    {
+        std::atomic_ref(segment->payload[i]).store(words[i], std::memory_order_relaxed);
+    }
+
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+StateViewer::StateViewer(const std::string &name)
+{
+#ifdef C2048_HAS_SHM
+    const auto object_name = SharedObjectName(name);
+    const int fd = shm_open(object_name.c_str(), O_RDONLY, 0);
+
+    if (fd < 0)
+    {
+        throw std::runtime_error("no shared memory object " + object_name);
+    }
+
+    struct stat info = {};
+
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedStateSegment))
+    {
+        close(fd);
+        throw std::runtime_error(object_name + " is not a game state");
+    }
+
+    segment = MapSegment(fd, PROT_READ);
+
+    if (!segment)
+    {
+        throw std::runtime_error("unable to map the shared memory object " + object_name);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (segment->magic != STATE_MAGIC || segment->version != STATE_VERSION || segment->words != SNAPSHOT_WORDS)
+    {
+        munmap(segment, sizeof(SharedStateSegment));
+        throw std::runtime_error(object_name + " is not a game state of this version");
+    }
+#else
+    throw std::runtime_error("shared memory viewing needs a POSIX system: " + name);
+#endif
+}
+
+StateViewer::~StateViewer()
+{
+#ifdef C2048_HAS_SHM
+    munmap(segment, sizeof(SharedStateSegment));
+#endif
+}
+
+auto StateViewer::Sequence() const -> std::uint64_t
+{
+    return std::atomic_ref(segment->sequence).load(std::memory_order_acquire);
+}
+
+auto StateViewer::Read() const -> std::optional<GameSnapshot>
+{
+    std::atomic_ref sequence(segment->sequence);
+    std::array<std::uint64_t, SNAPSHOT_WORDS> words = {};
+
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+    {
+        const auto before = sequence.load(std::memory_order_acquire);
+
+        // the writer is halfway through
+        if ((before & 1) != 0)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+        {
+            words[i] = std::atomic_ref(segment->payload[i]).load(std::memory_order_relaxed);
+        }
+
+        // the copy is complete before the sequence is read again
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (sequence.load(std::memory_order_relaxed) == before)
+        {
+            return DecodeSnapshot(words);
+        }
+    }
+
+    return std::nullopt;
+}
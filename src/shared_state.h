@@ -0,0 +1,87 @@
+#pragma once
+
+#include "game.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// A game as the processes watching it see it.
+struct GameSnapshot
+{
+    std::array<std::uint32_t, GRID_TILES> tiles = {};
+    std::uint64_t score = 0;
+    std::uint64_t best_score = 0;
+    std::uint64_t moves = 0;
+    GameState state = GameState::Startup;
+
+    auto operator==(const GameSnapshot &) const -> bool = default;
+};
+
+auto TakeSnapshot(Game &game) -> GameSnapshot;
+
+// the snapshot as the 64-bit words of the shared segment: two tiles per word, then the counters
+constexpr size_t SNAPSHOT_WORDS = GRID_TILES / 2 + 4;
+
+struct SharedStateSegment
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t words;
+    // the process publishing, so that a publisher under the same name can tell a live writer from a crashed one
+    std::int32_t writer_pid;
+    // odd while the writer is storing the payload; on its own line, since the viewers poll it
+    alignas(64) std::uint64_t sequence;
+    std::array<std::uint64_t, SNAPSHOT_WORDS> payload;
+};
+
+// Publishes a game into a POSIX shared-memory object for other processes (viewers, loggers, analysis) under a
+// seqlock: the writer makes the sequence odd, stores the payload and makes it even again, and a reader retries when
+// it saw an odd sequence or a different one after its copy. Publishing is a handful of stores into mapped memory, so
+// the game pays no syscall, no lock and never waits for a reader, however many there are.
+class StatePublisher
+{
+  private:
+    std::string name;
+    SharedStateSegment *segment = nullptr;
+
+  public:
+    // Creates the object, or takes over the one a crashed run left. Throws std::runtime_error, also when another
+    // live process publishes under the name: the seqlock allows a single writer.
+    explicit StatePublisher(const std::string &name);
+    // the object goes away with its writer, the viewers keep what they mapped
+    ~StatePublisher();
+
+    StatePublisher(const StatePublisher &) = delete;
+    StatePublisher(StatePublisher &&) = delete;
+    auto operator=(const StatePublisher &) -> StatePublisher & = delete;
+    auto operator=(StatePublisher &&) -> StatePublisher & = delete;
+
+    void Publish(const GameSnapshot &snapshot);
+};
+
+// Reads what a StatePublisher of the same name publishes.
+class StateViewer
+{
+  private:
+    // a writer stalled mid-update (e.g. descheduled) must not hang the reader
+    static constexpr int READ_ATTEMPTS = 1000;
+
+    SharedStateSegment *segment = nullptr;
+
+  public:
+    // throws std::runtime_error when there is no such object or it is not a game state
+    explicit StateViewer(const std::string &name);
+    ~StateViewer();
+
+    StateViewer(const StateViewer &) = delete;
+    StateViewer(StateViewer &&) = delete;
+    auto operator=(const StateViewer &) -> StateViewer & = delete;
+    auto operator=(StateViewer &&) -> StateViewer & = delete;
+
+    // changes with every publication, 0 before the first one: polling it is one load
+    [[nodiscard]] auto Sequence() const -> std::uint64_t;
+    // a consistent snapshot, none when the writer kept updating it through every attempt
+    [[nodiscard]] auto Read() const -> std::optional<GameSnapshot>;
+};
@@ -0,0 +1,114 @@
+#include "spectator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+SpectatorPool::SpectatorPool(const size_t games, const unsigned threads, const double moves_per_second,
+                             const std::uint32_t seed, SearchOptions options)
+    : slots(games), options(std::move(options)), moves_per_second(moves_per_second)
+{
+    const size_t n_workers = std::clamp<size_t>(threads, 1, std::max<size_t>(games, 1));
+
+    // contiguous ranges of games, one per worker
+    for (size_t worker = 0; worker < n_workers; ++worker)
+    {
+        const size_t first = games * worker / n_workers;
+        const size_t last = games * (worker + 1) / n_workers;
+
+        workers.emplace_back([this, first, last, seed](const std::stop_token &stop) {
+            Play(stop, first, last, seed + static_cast<std::uint32_t>(first));
+        });
+    }
+}
+
+void SpectatorPool::Publish(const size_t game, const CompactGame &compact_game)
+{
+    const auto status = (std::uint64_t{compact_game.Score()} << 32) | static_cast<std::uint64_t>(compact_game.State());
+
+    slots[game].board.store(compact_game.GetBoard(), std::memory_order_relaxed);
+    slots[game].status.store(status, std::memory_order_relaxed);
+}
+
+void SpectatorPool::Play(const std::stop_token &stop, const size_t first, const size_t last, std::uint32_t seed)
+{
+    std::vector<CompactGame> games;
+
+    for (size_t game = first; game < last; ++game)
+    {
+        games.emplace_back(seed++).Start();
+        Publish(game, games.back());
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto interval = moves_per_second > 0 ? std::chrono::duration_cast<Clock::duration>(
+                                                     std::chrono::duration<double>(1 / moves_per_second))
+                                               : Clock::duration::zero();
+    auto next_round = Clock::now();
+    // a search still running when the pool stops gives up
+    auto search_options = options;
+    search_options.should_stop = [&stop] { return stop.stop_requested(); };
+    Expectimax search(search_options);
+
+    while (!stop.stop_requested())
+    {
+        // one move of every game per round
+        for (size_t i = 0; i < games.size() && !stop.stop_requested(); ++i)
+        {
+            auto &game = games[i];
+
+            if (game.State() != GameState::Playing)
+            {
+                finished.fetch_add(1, std::memory_order_relaxed);
+                game = CompactGame(seed++);
+                game.Start();
+            }
+            else if (const auto move = search.BestMove(game.GetBoard()).move)
+            {
+                game.Move(*move);
+                moves.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            Publish(first + i, game);
+        }
+
+        if (interval == Clock::duration::zero())
+        {
+            continue;
+        }
+
+        // a round that took longer than the interval is not made up for
+        next_round = std::max(next_round + interval, Clock::now());
+
+        while (!stop.stop_requested() && Clock::now() < next_round)
+        {
+            // short naps, so that stopping the pool never waits for a slow pace
+            const auto nap = std::min<Clock::duration>(next_round - Clock::now(), std::chrono::milliseconds(50));
+            std::this_thread::sleep_for(nap);
+        }
+    }
+}
+
+auto SpectatorPool::Size() const -> size_t
+{
+    return slots.size();
+}
+
+auto SpectatorPool::Get(const size_t game) const -> SpectatorBoard
+{
+    const auto &slot = slots.at(game);
+    const auto status = slot.status.load(std::memory_order_relaxed);
+
+    return {slot.board.load(std::memory_order_relaxed), static_cast<std::uint32_t>(status >> 32),
+            static_cast<GameState>(status & 0xffffffff)};
+}
+
+auto SpectatorPool::Moves() const -> std::uint64_t
+{
+    return moves.load(std::memory_order_relaxed);
+}
+
+auto SpectatorPool::FinishedGames() const -> std::uint64_t
+{
+    return finished.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "board.h"
+#include "compact_game.h"
+#include "search.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// One game of the pool as the viewer sees it.
+struct SpectatorBoard
+{
+    Board board = 0;
+    std::uint32_t score = 0;
+    GameState state = GameState::Startup;
+};
+
+// Games played by the search on background threads, for the spectator view. Each game is a CompactGame owned by one
+// worker, which publishes its board and score in atomics after every move: the render thread reads any of them at
+// any time without a lock, and never makes a worker wait. Finished games start over with a new seed.
+class SpectatorPool
+{
+  private:
+    // a line per game, so that workers publishing neighbouring games never share one
+    struct alignas(64) Slot
+    {
+        std::atomic<Board> board = 0;
+        // score in the high half, state in the low one
+        std::atomic<std::uint64_t> status = 0;
+    };
+
+    std::vector<Slot> slots;
+    SearchOptions options;
+    double moves_per_second;
+    std::atomic<std::uint64_t> moves = 0;
+    std::atomic<std::uint64_t> finished = 0;
+    // last, so that the workers stop before anything they use goes away
+    std::vector<std::jthread> workers;
+
+  private:
+    void Play(const std::stop_token &stop, size_t first, size_t last, std::uint32_t seed);
+    void Publish(size_t game, const CompactGame &compact_game);
+
+  public:
+    // `moves_per_second` paces every game, 0 plays as fast as the search allows
+    SpectatorPool(size_t games, unsigned threads, double moves_per_second, std::uint32_t seed,
+                  SearchOptions options = {});
+
+    [[nodiscard]] auto Size() const -> size_t;
+    // the board and the score are read one after the other: the score may lag the board by a move
+    [[nodiscard]] auto Get(size_t game) const -> SpectatorBoard;
+    [[nodiscard]] auto Moves() const -> std::uint64_t;
+    [[nodiscard]] auto FinishedGames() const -> std::uint64_t;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue between exactly one producer thread and one consumer thread.
+template <typename T, size_t Capacity> class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+  private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::array<T, Capacity> items = {};
+    // head and tail on separate cache lines, so that producer and consumer do not false-share
+    alignas(CACHE_LINE) std::atomic<size_t> head = 0;
+    alignas(CACHE_LINE) std::atomic<size_t> tail = 0;
+
+  public:
+    // producer side, fails when the queue is full
+    auto TryPush(const T &item) -> bool
+    {
+        const size_t current_tail = tail.load(std::memory_order_relaxed);
+
+        if (current_tail - head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        items[current_tail & (Capacity - 1)] = item;
+        tail.store(current_tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side, fails when the queue is empty
+    auto TryPop(T &item) -> bool
+    {
+        const size_t current_head = head.load(std::memory_order_relaxed);
+
+        if (current_head == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = items[current_head & (Capacity - 1)];
+        head.store(current_head + 1, std::memory_order_release);
+        return true;
+    }
+};
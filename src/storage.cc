@@ -0,0 +1,232 @@
+#include "storage.h"
+
+#include <bit>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+constexpr std::string_view STORAGE_MAGIC = "C2048";
+// version 2 adds the endless flag, version 3 the state of the spawn generator
+constexpr int STORAGE_VERSION = 3;
+
+auto CaptureSession(Game &game) -> SessionState
+{
+    SessionState session;
+    session.best_score = game.BestScore();
+    session.score = game.Score();
+    session.seed = game.Seed();
+    session.state = game.State();
+    session.endless = game.Endless();
+    session.random = game.RandomState();
+
+    const Grid &grid = game.GetGrid();
+
+    for (size_t row = 0; row < grid.Rows(); ++row)
+    {
+        for (size_t col = 0; col < grid.Cols(); ++col)
+        {
+            session.tiles.at(row * grid.Cols() + col) = grid.GetTile(row, col).value;
+        }
+    }
+
+    return session;
+}
+
+void RestoreSession(Game &game, const SessionState &session)
+{
+    Grid grid;
+    grid.Init();
+
+    for (size_t row = 0; row < grid.Rows(); ++row)
+    {
+        for (size_t col = 0; col < grid.Cols(); ++col)
+        {
+            grid.SetTile(row, col, session.tiles.at(row * grid.Cols() + col));
+        }
+    }
+
+    game.Restore(grid, session.score, session.best_score, session.state, session.seed, session.endless,
+                 session.random);
+}
+
+auto DefaultStoragePath() -> std::filesystem::path
+{
+    return std::filesystem::path(USER_DATA_DIR) / "session.txt";
+}
+
+Storage::Storage(std::filesystem::path path) : path(std::move(path)), worker(&Storage::WorkerLoop, this)
+{
+}
+
+Storage::~Storage()
+{
+    {
+        const std::scoped_lock lock(mutex);
+        stopping = true;
+    }
+
+    pending_cv.notify_one();
+    worker.join();
+}
+
+void Storage::SaveAsync(const SessionState &session)
+{
+    {
+        const std::scoped_lock lock(mutex);
+        // only the latest session matters, older pending saves are simply replaced
+        pending = session;
+    }
+
+    pending_cv.notify_one();
+}
+
+void Storage::WorkerLoop()
+{
+    std::unique_lock lock(mutex);
+
+    while (true)
+    {
+        pending_cv.wait(lock, [this] { return stopping || pending.has_value(); });
+
+        if (!pending)
+        {
+            return;
+        }
+
+        const SessionState session = *pending;
+        pending.reset();
+
+        lock.unlock();
+
+        try
+        {
+            Write(session);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Unable to save session: " << e.what() << '\n';
+        }
+
+        lock.lock();
+    }
+}
+
+void Storage::Write(const SessionState &session) const
+{
+    std::filesystem::create_directories(path.parent_path());
+
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream out(tmp_path, std::ios::trunc);
+
+        out << STORAGE_MAGIC << ' ' << STORAGE_VERSION << '\n';
+        out << "best " << session.best_score << '\n';
+        out << "score " << session.score << '\n';
+        out << "state " << static_cast<int>(session.state) << '\n';
+        out << "seed " << session.seed << '\n';
+        out << "endless " << session.endless << '\n';
+        out << "random " << session.random << '\n';
+        out << "tiles";
+
+        for (const auto value : session.tiles)
+        {
+            out << ' ' << value;
+        }
+
+        out << '\n';
+        out.flush();
+
+        if (!out)
+        {
+            throw std::runtime_error("failed to write " + tmp_path.string());
+        }
+    }
+
+    // rename is atomic on the same filesystem: readers see either the old or the new session
+    std::filesystem::rename(tmp_path, path);
+}
+
+template <typename T> auto ReadField(std::istream &in, const std::string_view name, T &value) -> bool
+{
+    std::string key;
+    return in >> key >> value && key == name;
+}
+
+auto Storage::Load() const -> std::optional<SessionState>
+{
+    std::ifstream in(path);
+
+    if (!in)
+    {
+        return std::nullopt;
+    }
+
+    std::string magic;
+    int version = 0;
+    int state = 0;
+    std::string tiles_key;
+    SessionState session;
+
+    if (!(in >> magic >> version) || magic != STORAGE_MAGIC || version < 1 || version > STORAGE_VERSION)
+    {
+        return std::nullopt;
+    }
+
+    if (!ReadField(in, "best", session.best_score) || !ReadField(in, "score", session.score) ||
+        !ReadField(in, "state", state) || !ReadField(in, "seed", session.seed))
+    {
+        return std::nullopt;
+    }
+
+    if (version >= 2 && !ReadField(in, "endless", session.endless))
+    {
+        return std::nullopt;
+    }
+
+    if (version >= 3)
+    {
+        std::string random_key;
+        std::mt19937 engine;
+
+        // the engine state is the rest of the line, checked here so that restoring it cannot fail
+        if (!(in >> random_key) || random_key != "random" || !std::getline(in, session.random))
+        {
+            return std::nullopt;
+        }
+
+        if (session.random.starts_with(' '))
+        {
+            session.random.erase(0, 1);
+        }
+
+        if (!session.random.empty() && !(std::istringstream(session.random) >> engine))
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (!(in >> tiles_key) || tiles_key != "tiles")
+    {
+        return std::nullopt;
+    }
+
+    for (auto &value : session.tiles)
+    {
+        if (!(in >> value) || (value != 0 && (!std::has_single_bit(value) || value == 1 || value > MAX_TILE)))
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (state < 0 || state > static_cast<int>(GameState::Victory))
+    {
+        return std::nullopt;
+    }
+
+    session.state = static_cast<GameState>(state);
+    return session;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "game.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+struct SessionState
+{
+    std::uint64_t best_score = 0;
+    std::uint64_t score = 0;
+    std::uint32_t seed = 0;
+    GameState state = GameState::Startup;
+    bool endless = false;
+    // Game::RandomState(), so that the next spawns are those the game would have had; empty restarts the seed
+    std::string random;
+    std::array<std::uint32_t, 16> tiles = {};
+};
+
+auto CaptureSession(Game &game) -> SessionState;
+
+void RestoreSession(Game &game, const SessionState &session);
+
+auto DefaultStoragePath() -> std::filesystem::path;
+
+// Saves are handed to a background thread and written to a temporary file that is then renamed over the
+// previous one, so the caller never waits on the disk and a crash never leaves a half-written session.
+class Storage
+{
+  private:
+    std::filesystem::path path;
+    std::mutex mutex;
+    std::condition_variable pending_cv;
+    std::optional<SessionState> pending;
+    bool stopping = false;
+    std::thread worker;
+
+  private:
+    void WorkerLoop();
+    void Write(const SessionState &session) const;
+
+  public:
+    explicit Storage(std::filesystem::path path);
+    ~Storage();
+
+    Storage(const Storage &) = delete;
+    Storage(Storage &&) = delete;
+    auto operator=(const Storage &) -> Storage & = delete;
+    auto operator=(Storage &&) -> Storage & = delete;
+
+    [[nodiscard]] auto Load() const -> std::optional<SessionState>;
+    void SaveAsync(const SessionState &session);
+};
@@ -0,0 +1,356 @@
+#include "tablebase.h"
+
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+constexpr std::array<char, 8> TABLEBASE_MAGIC = {'C', '2', '0', '4', '8', 'T', 'B', '\0'};
+constexpr std::uint32_t TABLEBASE_VERSION = 1;
+constexpr std::uint64_t MAX_TABLEBASE_SIZE = std::uint64_t{1} << 31;
+constexpr float QUANTIZATION_SCALE = 65535.0f;
+constexpr std::uint64_t QUANTIZE_CHUNK = std::uint64_t{1} << 20;
+
+void TablebaseSpec::Validate() const
+{
+    if (max_exponent < 2 || max_exponent >= MAX_EXPONENT)
+    {
+        throw std::invalid_argument(std::format("max exponent must be in [2, {}]", MAX_EXPONENT - 1));
+    }
+
+    if (free_mask == 0)
+    {
+        throw std::invalid_argument("a tablebase needs at least one free cell");
+    }
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        const bool is_free = (free_mask >> i) & 1;
+
+        // spawns must land in free cells only, so every fixed cell holds a tile
+        if (is_free == (GetCell(fixed, i) != 0))
+        {
+            throw std::invalid_argument(std::format("cell {} must be {}", i, is_free ? "empty" : "a fixed tile"));
+        }
+    }
+}
+
+TablebaseIndex::TablebaseIndex(const TablebaseSpec &spec) : spec(spec)
+{
+    spec.Validate();
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        if ((spec.free_mask >> i) & 1)
+        {
+            free_cells.at(n_free) = static_cast<std::uint8_t>(i);
+            powers.at(n_free) = size;
+            size *= spec.max_exponent + 1;
+            ++n_free;
+
+            if (size > MAX_TABLEBASE_SIZE)
+            {
+                throw std::invalid_argument("tablebase has too many positions");
+            }
+        }
+        else
+        {
+            fixed_mask |= Board{0xf} << (4 * i);
+        }
+    }
+}
+
+auto TablebaseIndex::Spec() const -> const TablebaseSpec &
+{
+    return spec;
+}
+
+auto TablebaseIndex::Size() const -> std::uint64_t
+{
+    return size;
+}
+
+auto TablebaseIndex::FreeCount() const -> size_t
+{
+    return n_free;
+}
+
+auto TablebaseIndex::FreeCell(const size_t i) const -> std::uint8_t
+{
+    return free_cells.at(i);
+}
+
+auto TablebaseIndex::Power(const size_t i) const -> std::uint64_t
+{
+    return powers.at(i);
+}
+
+auto TablebaseIndex::KeepsFixedTiles(const Board board) const -> bool
+{
+    return (board & fixed_mask) == spec.fixed;
+}
+
+auto TablebaseIndex::Index(const Board board) const -> std::optional<std::uint64_t>
+{
+    if (!KeepsFixedTiles(board))
+    {
+        return std::nullopt;
+    }
+
+    std::uint64_t index = 0;
+
+    for (size_t i = 0; i < n_free; ++i)
+    {
+        const auto exponent = GetCell(board, free_cells.at(i));
+
+        if (exponent > spec.max_exponent)
+        {
+            return std::nullopt;
+        }
+
+        index += exponent * powers.at(i);
+    }
+
+    return index;
+}
+
+auto TablebaseIndex::PositionAt(std::uint64_t index) const -> Board
+{
+    Board board = spec.fixed;
+    const std::uint64_t base = spec.max_exponent + 1;
+
+    for (size_t i = 0; i < n_free; ++i)
+    {
+        board = SetCell(board, free_cells.at(i), static_cast<std::uint8_t>(index % base));
+        index /= base;
+    }
+
+    return board;
+}
+
+// Probability of reaching the target from `board` when the values of every position with a larger tile sum
+// are already known: spawns always add 2 or 4 to the sum and moves inside the subproblem never change it.
+auto SolvePosition(const TablebaseIndex &index, const std::vector<float> &values, const Board board) -> float
+{
+    const auto max_exponent = index.Spec().max_exponent;
+    float best = 0;
+
+    for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+    {
+        const Board after = MoveBoard(board, dir).board;
+
+        // moving a fixed tile leaves the subproblem, which counts as a loss
+        if (after == board || !index.KeepsFixedTiles(after))
+        {
+            continue;
+        }
+
+        if (MaxExponent(after & ~index.Spec().fixed) > max_exponent)
+        {
+            return 1.0f;
+        }
+
+        const std::uint64_t after_index = *index.Index(after);
+        float total = 0;
+        int n_empty = 0;
+
+        for (size_t i = 0; i < index.FreeCount(); ++i)
+        {
+            if (GetCell(after, index.FreeCell(i)) != 0)
+            {
+                continue;
+            }
+
+            total += static_cast<float>(PROB_2) * values[after_index + index.Power(i)] +
+                     static_cast<float>(PROB_4) * values[after_index + 2 * index.Power(i)];
+            ++n_empty;
+        }
+
+        best = std::max(best, total / static_cast<float>(n_empty));
+    }
+
+    return best;
+}
+
+// Appends the index of every position whose free cells, from `cell` on, hold tiles summing to twice `half_sum`.
+void CollectLayer(const TablebaseIndex &index, const size_t cell, const std::uint64_t half_sum,
+                  const std::uint64_t position, std::vector<std::uint32_t> &layer)
+{
+    if (cell == index.FreeCount())
+    {
+        if (half_sum == 0)
+        {
+            layer.push_back(static_cast<std::uint32_t>(position));
+        }
+
+        return;
+    }
+
+    const auto max_exponent = index.Spec().max_exponent;
+    const std::uint64_t largest_half = std::uint64_t{1} << (max_exponent - 1);
+
+    // the remaining cells cannot make up the sum even with the largest tiles
+    if (half_sum > (index.FreeCount() - cell) * largest_half)
+    {
+        return;
+    }
+
+    for (std::uint8_t exponent = 0; exponent <= max_exponent; ++exponent)
+    {
+        const std::uint64_t half = exponent == 0 ? 0 : std::uint64_t{1} << (exponent - 1);
+
+        if (half > half_sum)
+        {
+            break;
+        }
+
+        CollectLayer(index, cell + 1, half_sum - half, position + exponent * index.Power(cell), layer);
+    }
+}
+
+void GenerateTablebase(const TablebaseSpec &spec, const std::filesystem::path &path, unsigned threads)
+{
+    const TablebaseIndex index(spec);
+    const std::uint64_t size = index.Size();
+    threads = std::max(threads, 1U);
+
+    // the positions are solved by tile sum, which is even and bounded: a layer is listed only while it is solved, so
+    // that the values are the only array as large as the table
+    const size_t n_layers = index.FreeCount() * (size_t{1} << (spec.max_exponent - 1)) + 1;
+    std::vector<std::uint32_t> layer;
+
+    // retrograde pass: solve the layers from the largest sum down, every thread taking a slice of each layer
+    std::vector<float> values(size, 0.0f);
+    std::barrier sync(static_cast<std::ptrdiff_t>(threads));
+
+    auto worker = [&](const unsigned id) {
+        for (size_t half_sum = n_layers; half_sum-- > 0;)
+        {
+            if (id == 0)
+            {
+                layer.clear();
+                CollectLayer(index, 0, half_sum, 0, layer);
+            }
+
+            sync.arrive_and_wait();
+
+            const std::uint64_t count = layer.size();
+            const std::uint64_t slice_begin = count * id / threads;
+            const std::uint64_t slice_end = count * (id + 1) / threads;
+
+            for (std::uint64_t i = slice_begin; i < slice_end; ++i)
+            {
+                values[layer[i]] = SolvePosition(index, values, index.PositionAt(layer[i]));
+            }
+
+            sync.arrive_and_wait();
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+
+        for (unsigned id = 1; id < threads; ++id)
+        {
+            pool.emplace_back(worker, id);
+        }
+
+        worker(0);
+    }
+
+    TablebaseHeader header = {};
+    header.magic = TABLEBASE_MAGIC;
+    header.version = TABLEBASE_VERSION;
+    header.max_exponent = spec.max_exponent;
+    header.fixed = spec.fixed;
+    header.free_mask = spec.free_mask;
+    header.count = size;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // quantized a chunk at a time, rather than into a second copy of the table
+    std::vector<std::uint16_t> quantized(std::min<std::uint64_t>(size, QUANTIZE_CHUNK));
+
+    for (std::uint64_t begin = 0; begin < size && out; begin += quantized.size())
+    {
+        const auto count = std::min<std::uint64_t>(quantized.size(), size - begin);
+        const auto chunk = std::span(values).subspan(begin, count);
+
+        std::ranges::transform(chunk, quantized.begin(), [](const float value) {
+            return static_cast<std::uint16_t>(std::lround(value * QUANTIZATION_SCALE));
+        });
+        out.write(reinterpret_cast<const char *>(quantized.data()),
+                  static_cast<std::streamsize>(count * sizeof(std::uint16_t)));
+    }
+
+    if (!out)
+    {
+        throw std::runtime_error("failed to write " + path.string());
+    }
+}
+
+auto ReadTablebaseSpec(const MappedFile &file) -> TablebaseSpec
+{
+    const auto bytes = file.Bytes();
+    TablebaseHeader header = {};
+
+    if (bytes.size() < sizeof(header))
+    {
+        throw std::runtime_error("tablebase file is truncated");
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != TABLEBASE_MAGIC || header.version != TABLEBASE_VERSION)
+    {
+        throw std::runtime_error("not a tablebase file");
+    }
+
+    TablebaseSpec spec;
+    spec.fixed = header.fixed;
+    spec.free_mask = static_cast<std::uint16_t>(header.free_mask);
+    spec.max_exponent = static_cast<std::uint8_t>(header.max_exponent);
+
+    if (bytes.size() != sizeof(header) + header.count * sizeof(std::uint16_t))
+    {
+        throw std::runtime_error("tablebase file is truncated");
+    }
+
+    return spec;
+}
+
+Tablebase::Tablebase(const std::filesystem::path &path) : file(path), index(ReadTablebaseSpec(file))
+{
+    const auto bytes = file.Bytes().subspan(sizeof(TablebaseHeader));
+    values = {reinterpret_cast<const std::uint16_t *>(bytes.data()), bytes.size() / sizeof(std::uint16_t)};
+
+    if (values.size() != index.Size())
+    {
+        throw std::runtime_error("tablebase does not match its header");
+    }
+}
+
+auto Tablebase::Spec() const -> const TablebaseSpec &
+{
+    return index.Spec();
+}
+
+auto Tablebase::Probe(const Board board) const -> std::optional<float>
+{
+    // a mirrored or rotated layout is the same subproblem, one table answers for all 8 orientations
+    for (const Board symmetric : Symmetries(board))
+    {
+        if (const auto position = index.Index(symmetric))
+        {
+            return static_cast<float>(values[*position]) / QUANTIZATION_SCALE;
+        }
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "board.h"
+#include "mapped_file.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+// A tablebase solves a "last few tiles" subproblem: the cells outside `free_mask` hold the fixed tiles of
+// `fixed`, the free cells hold tiles up to 2^max_exponent, and the stored value is the probability of building a
+// 2^(max_exponent + 1) tile in the free cells with perfect play, without ever disturbing the fixed tiles.
+struct TablebaseSpec
+{
+    Board fixed = 0;
+    std::uint16_t free_mask = 0;
+    std::uint8_t max_exponent = 0;
+
+    void Validate() const;
+};
+
+// Positions of a subproblem are numbered by reading the free cells as digits in base max_exponent + 1,
+// which gives a dense, sorted key space: the table stores values only, never boards.
+class TablebaseIndex
+{
+  private:
+    TablebaseSpec spec;
+    Board fixed_mask = 0;
+    std::array<std::uint8_t, BOARD_CELLS> free_cells = {};
+    std::array<std::uint64_t, BOARD_CELLS> powers = {};
+    size_t n_free = 0;
+    std::uint64_t size = 1;
+
+  public:
+    explicit TablebaseIndex(const TablebaseSpec &spec);
+
+    [[nodiscard]] auto Spec() const -> const TablebaseSpec &;
+    [[nodiscard]] auto Size() const -> std::uint64_t;
+    [[nodiscard]] auto FreeCount() const -> size_t;
+    [[nodiscard]] auto FreeCell(size_t i) const -> std::uint8_t;
+    [[nodiscard]] auto Power(size_t i) const -> std::uint64_t;
+    [[nodiscard]] auto KeepsFixedTiles(Board board) const -> bool;
+    [[nodiscard]] auto Index(Board board) const -> std::optional<std::uint64_t>;
+    [[nodiscard]] auto PositionAt(std::uint64_t index) const -> Board;
+};
+
+struct TablebaseHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t max_exponent;
+    std::uint64_t fixed;
+    std::uint64_t free_mask;
+    std::uint64_t count;
+};
+
+// Solves every position of the subproblem into `path`. Memory is a float per position, (max_exponent + 1) ^ free cells
+// of them and at most 2^31 (8 GiB), plus the indices of the largest layer of one tile sum; the file takes two bytes
+// per position.
+void GenerateTablebase(const TablebaseSpec &spec, const std::filesystem::path &path, unsigned threads);
+
+// Probes a generated table straight from the memory-mapped file, two bytes per position.
+class Tablebase
+{
+  private:
+    MappedFile file;
+    TablebaseIndex index;
+    std::span<const std::uint16_t> values;
+
+  public:
+    explicit Tablebase(const std::filesystem::path &path);
+
+    [[nodiscard]] auto Spec() const -> const TablebaseSpec &;
+    [[nodiscard]] auto Probe(Board board) const -> std::optional<float>;
+};
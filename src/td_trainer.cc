@@ -0,0 +1,174 @@
+#include "td_trainer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+auto PlayTrainingGame(NTupleNetwork &network, const float learning_rate, std::mt19937 &gen, GameRecord *record)
+    -> EpisodeResult
+{
+    EpisodeResult result;
+    Board board = SpawnRandom(SpawnRandom(0, gen), gen);
+    std::optional<Board> previous_after;
+
+    if (record)
+    {
+        *record = {board, {}};
+    }
+
+    while (true)
+    {
+        std::optional<MoveResult> best;
+        std::optional<Direction> best_dir;
+        float best_value = 0;
+
+        for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            const auto move = MoveBoard(board, dir);
+
+            if (move.board == board)
+            {
+                continue;
+            }
+
+            const float value = static_cast<float>(move.score) + network.Evaluate(move.board);
+
+            if (!best || value > best_value)
+            {
+                best = move;
+                best_dir = dir;
+                best_value = value;
+            }
+        }
+
+        if (!best)
+        {
+            break;
+        }
+
+        // the value of the previous afterstate moves towards the reward and value of the next one
+        if (previous_after)
+        {
+            const float error = best_value - network.Evaluate(*previous_after);
+            network.Update(*previous_after, learning_rate * error);
+        }
+
+        previous_after = best->board;
+        result.score += best->score;
+        board = SpawnRandom(best->board, gen);
+
+        if (record)
+        {
+            record->Add(*best_dir, best->board, board);
+        }
+    }
+
+    // nothing follows the last afterstate
+    if (previous_after)
+    {
+        network.Update(*previous_after, -learning_rate * network.Evaluate(*previous_after));
+    }
+
+    result.max_exponent = MaxExponent(board);
+    return result;
+}
+
+void TrainNetwork(NTupleNetwork &network, const TrainOptions &options, const ProgressCallback &progress)
+{
+    const auto win_exponent = ValueToExponent(WIN_TILE);
+    std::atomic<std::uint64_t> next_game = 0;
+
+    // statistics of the games since the last report
+    std::mutex report_mutex;
+    std::uint64_t window_games = 0;
+    std::uint64_t window_score = 0;
+    std::uint64_t window_wins = 0;
+    std::uint8_t window_max = 0;
+
+    std::optional<GameRecordWriter> writer;
+    // checkpoints share one temporary file, a second one would truncate it under the rename of the first
+    std::mutex checkpoint_mutex;
+
+    if (!options.record_path.empty())
+    {
+        writer.emplace(options.record_path);
+    }
+
+    auto worker = [&](const unsigned id) {
+        std::mt19937 gen(options.seed + id);
+        GameRecord record;
+
+        while (true)
+        {
+            const std::uint64_t game = next_game.fetch_add(1, std::memory_order_relaxed);
+
+            if (game >= options.games)
+            {
+                return;
+            }
+
+            const auto episode = PlayTrainingGame(network, options.learning_rate, gen, writer ? &record : nullptr);
+            const std::uint64_t played = game + 1;
+
+            if (options.checkpoint_every > 0 && played % options.checkpoint_every == 0)
+            {
+                try
+                {
+                    const std::scoped_lock checkpoint_lock(checkpoint_mutex);
+                    network.Save(options.checkpoint_path);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "Unable to save checkpoint: " << e.what() << '\n';
+                }
+            }
+
+            const std::scoped_lock lock(report_mutex);
+
+            if (writer)
+            {
+                writer->Write(record);
+            }
+
+            ++window_games;
+            window_score += episode.score;
+            window_wins += episode.max_exponent >= win_exponent ? 1 : 0;
+            window_max = std::max(window_max, episode.max_exponent);
+
+            if (progress && (window_games >= options.report_every || played == options.games))
+            {
+                TrainProgress report;
+                report.games = played;
+                report.mean_score = static_cast<double>(window_score) / static_cast<double>(window_games);
+                report.win_rate = static_cast<double>(window_wins) / static_cast<double>(window_games);
+                report.max_exponent = window_max;
+                progress(report);
+
+                window_games = 0;
+                window_score = 0;
+                window_wins = 0;
+                window_max = 0;
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+
+        for (unsigned id = 1; id < std::max(options.threads, 1U); ++id)
+        {
+            pool.emplace_back(worker, id);
+        }
+
+        worker(0);
+    }
+
+    if (writer)
+    {
+        writer->Flush();
+    }
+}
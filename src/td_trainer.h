@@ -0,0 +1,48 @@
+#pragma once
+
+#include "game_record.h"
+#include "ntuple.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <random>
+
+struct TrainOptions
+{
+    std::uint64_t games = 100000;
+    unsigned threads = 1;
+    float learning_rate = 0.1f;
+    std::uint32_t seed = 0;
+    std::uint64_t report_every = 1000;
+    // 0 disables checkpoints
+    std::uint64_t checkpoint_every = 0;
+    std::filesystem::path checkpoint_path;
+    // the played games are recorded for 2048_stats when set
+    std::filesystem::path record_path;
+};
+
+struct TrainProgress
+{
+    std::uint64_t games = 0;
+    double mean_score = 0;
+    // share of the games that reached WIN_TILE
+    double win_rate = 0;
+    std::uint8_t max_exponent = 0;
+};
+
+struct EpisodeResult
+{
+    std::uint64_t score = 0;
+    std::uint8_t max_exponent = 0;
+};
+
+using ProgressCallback = std::function<void(const TrainProgress &)>;
+
+// Plays one game greedily on the network and learns from it with TD(0) over afterstates. The moves are appended to
+// `record` unless it is null.
+auto PlayTrainingGame(NTupleNetwork &network, float learning_rate, std::mt19937 &gen, GameRecord *record)
+    -> EpisodeResult;
+
+// Self-play training on `options.threads` threads sharing the same weights without locks.
+void TrainNetwork(NTupleNetwork &network, const TrainOptions &options, const ProgressCallback &progress);
@@ -0,0 +1,152 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+// Buffers outlive their threads, so that the events of finished workers are still flushed.
+struct TraceRegistry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+auto GetTraceRegistry() -> TraceRegistry &
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+auto ThreadTraceBuffer() -> TraceBuffer &
+{
+    // the registry lock is only taken once per thread
+    thread_local TraceBuffer *buffer = [] {
+        auto &registry = GetTraceRegistry();
+        const std::scoped_lock lock(registry.mutex);
+        const auto thread = static_cast<std::uint32_t>(registry.buffers.size() + 1);
+        return registry.buffers.emplace_back(std::make_unique<TraceBuffer>(thread)).get();
+    }();
+
+    return *buffer;
+}
+
+auto TraceClock() -> std::uint64_t
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::steady_clock::now() - epoch;
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+TraceBuffer::TraceBuffer(const std::uint32_t thread, const size_t capacity) : slots(capacity), thread(thread)
+{
+}
+
+void TraceBuffer::Record(const char *name, const std::uint64_t begin_ns, const std::uint64_t end_ns)
+{
+    const auto index = written.load(std::memory_order_relaxed);
+    auto &slot = slots[index % slots.size()];
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    written.store(index + 1, std::memory_order_release);
+}
+
+auto TraceBuffer::Snapshot() const -> std::vector<TraceEvent>
+{
+    const auto end = written.load(std::memory_order_acquire);
+    const auto begin = end > slots.size() ? end - slots.size() : 0;
+
+    std::vector<TraceEvent> events;
+    events.reserve(end - begin);
+
+    for (auto index = begin; index < end; ++index)
+    {
+        const auto &slot = slots[index % slots.size()];
+        events.push_back({slot.name.load(std::memory_order_relaxed), slot.begin_ns.load(std::memory_order_relaxed),
+                          slot.end_ns.load(std::memory_order_relaxed), thread});
+    }
+
+    // the writer kept going while copying: the oldest slots may now hold newer events, or a half-written one
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto touched = written.load(std::memory_order_relaxed) + 1;
+    const auto overwritten = touched > begin + slots.size() ? touched - begin - slots.size() : 0;
+
+    events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(std::min(overwritten, end - begin)));
+    return events;
+}
+
+TraceScope::TraceScope(const char *name) : name(name), begin_ns(TraceClock())
+{
+}
+
+TraceScope::~TraceScope()
+{
+    // read the clock first, so that the first event of a thread does not include allocating its buffer
+    const auto end_ns = TraceClock();
+    ThreadTraceBuffer().Record(name, begin_ns, end_ns);
+}
+
+auto CollectTraceEvents() -> std::vector<TraceEvent>
+{
+    std::vector<TraceEvent> events;
+    auto &registry = GetTraceRegistry();
+
+    {
+        const std::scoped_lock lock(registry.mutex);
+
+        for (const auto &buffer : registry.buffers)
+        {
+            const auto snapshot = buffer->Snapshot();
+            events.insert(events.end(), snapshot.begin(), snapshot.end());
+        }
+    }
+
+    std::ranges::sort(events, {}, &TraceEvent::begin_ns);
+    return events;
+}
+
+auto FormatChromeTrace(const std::vector<TraceEvent> &events) -> std::string
+{
+    std::string json = "{\"traceEvents\":[\n";
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto &event = events[i];
+        // complete events, timestamps in microseconds
+        json += std::format(R"({{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})", event.name,
+                            static_cast<double>(event.begin_ns) / 1000.0,
+                            static_cast<double>(event.end_ns - event.begin_ns) / 1000.0, event.thread);
+        json += i + 1 < events.size() ? ",\n" : "\n";
+    }
+
+    json += "],\"displayTimeUnit\":\"ms\"}\n";
+    return json;
+}
+
+void WriteChromeTrace(const std::filesystem::path &path)
+{
+    const auto json = FormatChromeTrace(CollectTraceEvents());
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+
+        if (!file || !file.write(json.data(), static_cast<std::streamsize>(json.size())))
+        {
+            throw std::runtime_error("unable to write " + tmp_path.string());
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path);
+}
+
+auto DefaultTracePath() -> std::filesystem::path
+{
+    return std::filesystem::path(USER_DATA_DIR) / "trace.json";
+}
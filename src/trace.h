@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Scoped hot-path instrumentation. TRACE_SCOPE("Game::Move") records when the enclosing scope begins and ends
+// into a ring buffer owned by the calling thread; WriteChromeTrace dumps all the buffers as a Chrome/Perfetto
+// trace. The macros compile to nothing unless the build enables C2048_TRACING.
+#ifdef C2048_TRACING
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) const TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+// events kept per thread, older ones are overwritten
+constexpr size_t TRACE_BUFFER_EVENTS = 1 << 15;
+
+struct TraceEvent
+{
+    // a string literal: only the pointer is recorded
+    const char *name;
+    std::uint64_t begin_ns;
+    std::uint64_t end_ns;
+    std::uint32_t thread;
+};
+
+// Single-writer ring: only the owning thread records, any thread may snapshot it concurrently.
+class TraceBuffer
+{
+  private:
+    struct Slot
+    {
+        std::atomic<const char *> name = nullptr;
+        std::atomic<std::uint64_t> begin_ns = 0;
+        std::atomic<std::uint64_t> end_ns = 0;
+    };
+
+    std::vector<Slot> slots;
+    // events ever recorded, the next one goes to written % size
+    std::atomic<std::uint64_t> written = 0;
+    std::uint32_t thread;
+
+  public:
+    explicit TraceBuffer(std::uint32_t thread, size_t capacity = TRACE_BUFFER_EVENTS);
+
+    void Record(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns);
+    // the events still in the ring, oldest first, without the ones overwritten while copying
+    [[nodiscard]] auto Snapshot() const -> std::vector<TraceEvent>;
+};
+
+class TraceScope
+{
+  private:
+    const char *name;
+    std::uint64_t begin_ns;
+
+  public:
+    explicit TraceScope(const char *name);
+    ~TraceScope();
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope(TraceScope &&) = delete;
+    auto operator=(const TraceScope &) -> TraceScope & = delete;
+    auto operator=(TraceScope &&) -> TraceScope & = delete;
+};
+
+// nanoseconds since the first call in the process
+auto TraceClock() -> std::uint64_t;
+// the events of every thread that recorded one, ordered by begin time
+auto CollectTraceEvents() -> std::vector<TraceEvent>;
+auto FormatChromeTrace(const std::vector<TraceEvent> &events) -> std::string;
+// Written next to a .tmp file first, like the session. Throws std::runtime_error when it cannot be written.
+void WriteChromeTrace(const std::filesystem::path &path);
+auto DefaultTracePath() -> std::filesystem::path;
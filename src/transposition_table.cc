@@ -0,0 +1,299 @@
+#include "transposition_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define C2048_HAS_MMAP 1
+#endif
+
+constexpr std::uint64_t OCCUPIED_BIT = std::uint64_t{1} << 63;
+constexpr int DEPTH_SHIFT = 32;
+constexpr int MOVE_SHIFT = 40;
+constexpr int GENERATION_SHIFT = 48;
+constexpr std::uint64_t HASH_MULTIPLIER = 0x9e3779b97f4a7c15;
+constexpr std::array<char, 8> TABLE_FILE_MAGIC = {'C', '2', '0', '4', '8', 'T', 'T', '\0'};
+constexpr std::uint32_t TABLE_FILE_FORMAT = 1;
+
+// processes share slots through the same atomics, and threads of one process its generation
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic_ref<std::uint8_t>::is_always_lock_free);
+
+auto PackEntry(const int depth, const float value, const std::optional<Direction> move, const std::uint8_t generation)
+    -> std::uint64_t
+{
+    const std::uint64_t move_bits = move ? static_cast<std::uint64_t>(*move) + 1 : 0;
+
+    return OCCUPIED_BIT | (std::uint64_t{generation} << GENERATION_SHIFT) | (move_bits << MOVE_SHIFT) |
+           (static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << DEPTH_SHIFT) |
+           std::bit_cast<std::uint32_t>(value);
+}
+
+auto EntryDepth(const std::uint64_t data) -> int
+{
+    return static_cast<int>((data >> DEPTH_SHIFT) & 0xff);
+}
+
+auto EntryGeneration(const std::uint64_t data) -> std::uint8_t
+{
+    return static_cast<std::uint8_t>(data >> GENERATION_SHIFT);
+}
+
+void TranspositionTable::SetCapacity(const size_t megabytes)
+{
+    const size_t bytes = std::max(megabytes, size_t{1}) << 20;
+    const size_t n_buckets = std::bit_floor(bytes / (BUCKET_SLOTS * sizeof(Slot)));
+
+    n_slots = n_buckets * BUCKET_SLOTS;
+    bucket_mask = n_buckets - 1;
+}
+
+TranspositionTable::TranspositionTable(const size_t megabytes, const bool huge_pages)
+{
+    SetCapacity(megabytes);
+    mapped_bytes = n_slots * sizeof(Slot);
+
+#ifdef C2048_HAS_MMAP
+    // anonymous pages are zeroed (empty slots) and only committed once touched
+    mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+    {
+        madvise(mapping, mapped_bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    slots = static_cast<Slot *>(mapping);
+#else
+    (void)huge_pages;
+    slots = new Slot[n_slots]();
+#endif
+}
+
+#ifdef C2048_HAS_MMAP
+auto IsBlankHeader(const TableFileHeader &header) -> bool
+{
+    const auto bytes = std::as_bytes(std::span(&header, 1));
+    return std::ranges::all_of(bytes, [](const std::byte b) { return b == std::byte{0}; });
+}
+#endif
+
+TranspositionTable::TranspositionTable(const std::filesystem::path &path, const size_t megabytes,
+                                       const std::uint64_t version)
+{
+#ifdef C2048_HAS_MMAP
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+
+    if (fd < 0)
+    {
+        throw std::runtime_error("unable to open " + path.string());
+    }
+
+    const auto fail = [fd, &path](const std::string &reason) {
+        close(fd);
+        throw std::runtime_error(path.string() + ": " + reason);
+    };
+
+    // only opening locks the file: the first process sizes and stamps it while the others wait
+    flock(fd, LOCK_EX);
+
+    struct stat info = {};
+    TableFileHeader header = {};
+
+    if (fstat(fd, &info) != 0)
+    {
+        fail("unable to stat");
+    }
+
+    // a crash between sizing the file and stamping it leaves an all-zero header, which is still ours to initialize
+    const bool has_header = static_cast<size_t>(info.st_size) >= sizeof(header) &&
+                            pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+    const bool blank = info.st_size == 0 || (has_header && IsBlankHeader(header));
+
+    if (blank)
+    {
+        SetCapacity(megabytes);
+        header.magic = TABLE_FILE_MAGIC;
+        header.format = TABLE_FILE_FORMAT;
+        header.slot_size = sizeof(Slot);
+        header.n_slots = n_slots;
+        header.version = version;
+
+        // the slots stay a hole in the file, which reads as zeroes: empty slots
+        if (ftruncate(fd, static_cast<off_t>(sizeof(header) + n_slots * sizeof(Slot))) != 0 ||
+            pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            fail("unable to create the table");
+        }
+
+        info.st_size = static_cast<off_t>(sizeof(header) + n_slots * sizeof(Slot));
+    }
+    else if (!has_header || header.magic != TABLE_FILE_MAGIC || header.format != TABLE_FILE_FORMAT ||
+             header.slot_size != sizeof(Slot))
+    {
+        fail("not a transposition table of this format");
+    }
+
+    if (header.version != version)
+    {
+        fail("holds values of version " + std::to_string(header.version) + ", expected " + std::to_string(version));
+    }
+
+    const auto n_buckets = header.n_slots / BUCKET_SLOTS;
+
+    if (n_buckets == 0 || !std::has_single_bit(n_buckets) ||
+        static_cast<std::uint64_t>(info.st_size) != sizeof(header) + header.n_slots * sizeof(Slot))
+    {
+        fail("truncated or corrupted table");
+    }
+
+    n_slots = header.n_slots;
+    bucket_mask = n_buckets - 1;
+    mapped_bytes = sizeof(header) + n_slots * sizeof(Slot);
+    mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        fail("unable to map");
+    }
+
+    // the mapping keeps its own reference to the file
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    slots = reinterpret_cast<Slot *>(static_cast<std::byte *>(mapping) + sizeof(TableFileHeader));
+    // Processes started together move in lockstep, so starting from 0 they would all share one generation and the
+    // entries of the others would look current. Starting from the low byte of the pid, any 256 consecutive pids age
+    // entries with distinct generations.
+    generation = static_cast<std::uint8_t>(getpid());
+#else
+    (void)megabytes;
+    (void)version;
+    throw std::runtime_error("shared transposition tables need mmap: " + path.string());
+#endif
+}
+
+TranspositionTable::~TranspositionTable()
+{
+#ifdef C2048_HAS_MMAP
+    munmap(mapping, mapped_bytes);
+#else
+    delete[] slots;
+#endif
+}
+
+auto TranspositionTable::Capacity() const -> size_t
+{
+    return n_slots;
+}
+
+auto TranspositionTable::Bucket(const Board board) const -> Slot *
+{
+    const std::uint64_t hash = board * HASH_MULTIPLIER;
+    return slots + ((hash >> 32) & bucket_mask) * BUCKET_SLOTS;
+}
+
+auto TranspositionTable::Probe(const Board board) const -> std::optional<TableEntry>
+{
+    Slot *bucket = Bucket(board);
+
+    for (size_t i = 0; i < BUCKET_SLOTS; ++i)
+    {
+        const auto data = std::atomic_ref(bucket[i].data).load(std::memory_order_relaxed);
+        const auto check = std::atomic_ref(bucket[i].check).load(std::memory_order_relaxed);
+
+        // a torn slot does not verify and reads as a miss
+        if ((data & OCCUPIED_BIT) == 0 || (check ^ data) != board)
+        {
+            continue;
+        }
+
+        const auto move_bits = (data >> MOVE_SHIFT) & 0x7;
+        std::optional<Direction> move;
+
+        if (move_bits != 0)
+        {
+            move = static_cast<Direction>(move_bits - 1);
+        }
+
+        return TableEntry{std::bit_cast<float>(static_cast<std::uint32_t>(data)), EntryDepth(data), move};
+    }
+
+    return std::nullopt;
+}
+
+void TranspositionTable::Store(const Board board, const int depth, const float value,
+                               const std::optional<Direction> move)
+{
+    const auto current = std::atomic_ref(generation).load(std::memory_order_relaxed);
+    Slot *bucket = Bucket(board);
+    Slot *victim = nullptr;
+    int victim_score = 0;
+
+    for (size_t i = 0; i < BUCKET_SLOTS; ++i)
+    {
+        const auto data = std::atomic_ref(bucket[i].data).load(std::memory_order_relaxed);
+        const auto check = std::atomic_ref(bucket[i].check).load(std::memory_order_relaxed);
+
+        if ((data & OCCUPIED_BIT) == 0)
+        {
+            victim = &bucket[i];
+            break;
+        }
+
+        if ((check ^ data) == board)
+        {
+            // keep a deeper result of the current search
+            if (EntryGeneration(data) == current && EntryDepth(data) > depth)
+            {
+                return;
+            }
+
+            victim = &bucket[i];
+            break;
+        }
+
+        // entries of older searches go first, then the shallowest
+        const int score = (EntryGeneration(data) == current ? 256 : 0) + EntryDepth(data);
+
+        if (victim == nullptr || score < victim_score)
+        {
+            victim = &bucket[i];
+            victim_score = score;
+        }
+    }
+
+    const auto data = PackEntry(depth, value, move, current);
+    std::atomic_ref(victim->data).store(data, std::memory_order_relaxed);
+    std::atomic_ref(victim->check).store(board ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::NewSearch()
+{
+    std::atomic_ref(generation).fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear()
+{
+    for (size_t i = 0; i < n_slots; ++i)
+    {
+        std::atomic_ref(slots[i].data).store(0, std::memory_order_relaxed);
+        std::atomic_ref(slots[i].check).store(0, std::memory_order_relaxed);
+    }
+}
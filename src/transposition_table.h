@@ -0,0 +1,89 @@
+#pragma once
+
+#include "board.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+struct TableEntry
+{
+    float value;
+    int depth;
+    std::optional<Direction> move;
+};
+
+// First cache line of a table file, the slots follow it.
+struct TableFileHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t format;
+    std::uint32_t slot_size;
+    std::uint64_t n_slots;
+    // what the values mean, given by the owner of the file: tables of another evaluator are refused
+    std::uint64_t version;
+    // the first byte held a generation shared by every process in the first files, it is ignored
+    std::array<std::uint8_t, 32> reserved;
+};
+
+static_assert(sizeof(TableFileHeader) == 64);
+
+// Fixed-size, open-addressed cache of search results keyed on packed boards. Slots are grouped in buckets of
+// one cache line; a board may live in any slot of its bucket.
+//
+// Concurrent readers and writers never lock: every slot stores `key ^ data` next to `data`, so a slot torn by
+// two racing writers fails verification and simply reads as a miss. Within a bucket, entries of older searches
+// are evicted first, then the shallowest one: deep results are the most expensive to recompute.
+//
+// A table opened on a file is a shared mapping of it: every process that opens the same file reads and writes the
+// same slots through the same lock-free protocol, and the results outlive the processes for the next run.
+class TranspositionTable
+{
+  private:
+    // accessed through std::atomic_ref, so that zeroed pages are valid slots without construction
+    struct Slot
+    {
+        std::uint64_t check;
+        std::uint64_t data;
+    };
+
+    static constexpr size_t BUCKET_SLOTS = 4;
+
+    Slot *slots = nullptr;
+    size_t n_slots = 0;
+    size_t bucket_mask = 0;
+    // the whole mapping, with the header of a file
+    void *mapping = nullptr;
+    size_t mapped_bytes = 0;
+    // accessed through std::atomic_ref; every process has its own, so that its moves never age the entries others
+    // are still searching with, and the entries of others only count as current when their generations coincide
+    std::uint8_t generation = 0;
+
+  private:
+    [[nodiscard]] auto Bucket(Board board) const -> Slot *;
+    void SetCapacity(size_t megabytes);
+
+  public:
+    // `huge_pages` asks the OS to back the table with huge pages, when it can
+    explicit TranspositionTable(size_t megabytes, bool huge_pages = false);
+    // Opens the table stored in `path`, or creates it with `megabytes` of slots: an existing file keeps its own size.
+    // Throws std::runtime_error when the file cannot be mapped, or holds another format or `version` of values.
+    TranspositionTable(const std::filesystem::path &path, size_t megabytes, std::uint64_t version);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable(TranspositionTable &&) = delete;
+    auto operator=(const TranspositionTable &) -> TranspositionTable & = delete;
+    auto operator=(TranspositionTable &&) -> TranspositionTable & = delete;
+
+    [[nodiscard]] auto Capacity() const -> size_t;
+    [[nodiscard]] auto Probe(Board board) const -> std::optional<TableEntry>;
+    void Store(Board board, int depth, float value, std::optional<Direction> move);
+    // ages the current entries, so that the next search can replace them first. On a file, the entries of other
+    // processes already count as older ones: they are still read, but replaced before this process's own.
+    void NewSearch();
+    void Clear();
+};
@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "counters.h"
 
 void SetRenderColor(SDL_Renderer *renderer, const SDL_Color &color)
 {
@@ -11,6 +12,12 @@ void FillRect(SDL_Renderer *renderer, const SDL_FRect *rect, const SDL_Color &co
     SDL_RenderFillRect(renderer, rect);
 }
 
+auto ToFColor(const SDL_Color &color) -> SDL_FColor
+{
+    constexpr float MAX = 255;
+    return {color.r / MAX, color.g / MAX, color.b / MAX, color.a / MAX};
+}
+
 void AlignTextRect(SDL_FRect &rect, const float text_height, const float text_width, const TextAlignment alignment)
 {
     switch (alignment)
@@ -52,5 +59,6 @@ auto AdjustFontSizeToFitRect(SDL_Surface *surface, TTF_Font *font, const std::st
 
         TTF_SetFontSize(font, --font_size);
         surface = TTF_RenderText_Solid(font, text.data(), 0, {});
+        CountEvent(Counter::TextRasterizations);
     }
 }
\ No newline at end of file
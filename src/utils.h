@@ -15,6 +15,9 @@ void SetRenderColor(SDL_Renderer *renderer, const SDL_Color &color);
 
 void FillRect(SDL_Renderer *renderer, const SDL_FRect *rect, const SDL_Color &color);
 
+// the colour of a vertex for SDL_RenderGeometry
+auto ToFColor(const SDL_Color &color) -> SDL_FColor;
+
 void AlignTextRect(SDL_FRect &rect, float text_height, float text_width, TextAlignment alignment);
 
 auto AdjustFontSizeToFitRect(SDL_Surface *surface, TTF_Font *font, std::string_view text, float size, float height,
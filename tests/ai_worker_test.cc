@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "../src/ai_worker.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+// polls like the render loop does, giving up after a few seconds
+static auto WaitForResult(const AiWorker &worker, const std::uint32_t id) -> std::optional<Direction>
+{
+    for (int attempt = 0; attempt < 5000; ++attempt)
+    {
+        if (const auto move = worker.Result(id))
+        {
+            return move;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return std::nullopt;
+}
+
+TEST(TestSpscQueue, PushAndPopInOrder)
+{
+    SpscQueue<int, 4> queue;
+    int item = 0;
+    EXPECT_FALSE(queue.TryPop(item));
+
+    for (int value = 1; value <= 4; ++value)
+    {
+        EXPECT_TRUE(queue.TryPush(value));
+    }
+
+    EXPECT_FALSE(queue.TryPush(5));
+
+    for (int value = 1; value <= 4; ++value)
+    {
+        ASSERT_TRUE(queue.TryPop(item));
+        EXPECT_EQ(item, value);
+    }
+
+    EXPECT_FALSE(queue.TryPop(item));
+}
+
+TEST(TestSpscQueue, ConcurrentProducerAndConsumer)
+{
+    SpscQueue<int, 8> queue;
+    constexpr int count = 10000;
+
+    std::jthread producer([&queue] {
+        for (int value = 0; value < count; ++value)
+        {
+            while (!queue.TryPush(value))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int item = 0;
+
+    while (expected < count)
+    {
+        if (queue.TryPop(item))
+        {
+            ASSERT_EQ(item, expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TEST(TestAiWorker, PublishesTheSearchResult)
+{
+    const Board board = 0x0000'0121'0312'2431;
+
+    SearchOptions options;
+    options.depth = 2;
+    const auto expected = Expectimax(options).BestMove(board);
+
+    AiWorker worker(options);
+    const auto id = worker.Post(board);
+
+    EXPECT_EQ(WaitForResult(worker, id), expected.move);
+    EXPECT_GT(worker.SearchedNodes(), 0);
+}
+
+TEST(TestAiWorker, NewerPostSupersedesOlder)
+{
+    SearchOptions options;
+    options.depth = 2;
+    AiWorker worker(options);
+
+    const auto first = worker.Post(0x0000'0121'0312'2431);
+    const auto second = worker.Post(0x0000'0000'0000'0011);
+    EXPECT_NE(first, second);
+
+    EXPECT_EQ(WaitForResult(worker, second), Expectimax(options).BestMove(0x0000'0000'0000'0011).move);
+    EXPECT_FALSE(worker.Result(first).has_value());
+}
+
+TEST(TestAiWorker, CancelStopsALongSearch)
+{
+    SearchOptions options;
+    // far too deep to finish within the test
+    options.depth = 12;
+    auto worker = std::make_unique<AiWorker>(options);
+
+    const auto id = worker->Post(0x0000'0000'0000'0011);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    worker->Cancel();
+
+    // destroying the worker joins its thread, which only happens quickly if the search was aborted
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(worker->Result(id).has_value());
+    worker.reset();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+}
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include "../src/board.h"
+
+#include <random>
+
+auto RandomBoard(std::mt19937 &gen) -> Board
+{
+    // mostly small tiles, so that merges are frequent
+    std::uniform_int_distribution<int> exponent_dist(0, 6);
+    Board board = 0;
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        board = SetCell(board, i, static_cast<std::uint8_t>(exponent_dist(gen)));
+    }
+
+    return board;
+}
+
+TEST(TestBoard, PackUnpack)
+{
+    Grid grid;
+    grid.Init();
+    grid.SetTile(0, 0, 2);
+    grid.SetTile(1, 3, 2048);
+    grid.SetTile(3, 3, 32768);
+
+    const Board board = PackGrid(grid);
+    EXPECT_EQ(GetCell(board, 0), 1);
+    EXPECT_EQ(GetCell(board, 7), 11);
+    EXPECT_EQ(GetCell(board, 15), 15);
+
+    Grid unpacked;
+    UnpackGrid(board, unpacked);
+
+    for (size_t row = 0; row < grid.Rows(); ++row)
+    {
+        for (size_t col = 0; col < grid.Cols(); ++col)
+        {
+            EXPECT_EQ(unpacked.GetTile(row, col).value, grid.GetTile(row, col).value);
+            EXPECT_EQ(unpacked.GetTile(row, col).row, row);
+            EXPECT_EQ(unpacked.GetTile(row, col).col, col);
+        }
+    }
+}
+
+TEST(TestBoard, PackInvalidValue)
+{
+    Grid grid;
+    grid.Init();
+    grid.SetTile(0, 0, 3);
+    ASSERT_THROW((void)PackGrid(grid), std::out_of_range);
+}
+
+TEST(TestBoard, PackLargeTiles)
+{
+    Grid grid;
+    grid.Init();
+    grid.SetTile(0, 0, 32768);
+    EXPECT_TRUE(CanPackGrid(grid));
+    EXPECT_EQ(GetCell(PackGrid(grid), 0), 15);
+
+    grid.SetTile(0, 0, 65536);
+    EXPECT_FALSE(CanPackGrid(grid));
+    ASSERT_THROW((void)PackGrid(grid), std::out_of_range);
+}
+
+TEST(TestBoard, Transpose)
+{
+    std::mt19937 gen(1);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        const Board board = RandomBoard(gen);
+        const Board transposed = Transpose(board);
+
+        for (size_t row = 0; row < BOARD_SIZE; ++row)
+        {
+            for (size_t col = 0; col < BOARD_SIZE; ++col)
+            {
+                ASSERT_EQ(GetCell(transposed, col * BOARD_SIZE + row), GetCell(board, row * BOARD_SIZE + col));
+            }
+        }
+
+        ASSERT_EQ(Transpose(transposed), board);
+    }
+}
+
+TEST(TestBoard, CountEmptyAndMax)
+{
+    Board board = 0;
+    EXPECT_EQ(CountEmpty(board), 16);
+    EXPECT_EQ(MaxExponent(board), 0);
+
+    board = SetCell(board, 3, 1);
+    board = SetCell(board, 9, 8);
+    EXPECT_EQ(CountEmpty(board), 14);
+    EXPECT_EQ(MaxExponent(board), 8);
+    EXPECT_EQ(TileSum(board), 258);
+}
+
+TEST(TestBoard, MoveRowScore)
+{
+    // 2 2 4 4 -> 4 8 0 0
+    const Board board = 0x2211;
+    const auto [left, left_score] = MoveBoard(board, Direction::LEFT);
+    EXPECT_EQ(left, 0x32);
+    EXPECT_EQ(left_score, 12);
+
+    const auto [right, right_score] = MoveBoard(board, Direction::RIGHT);
+    EXPECT_EQ(right, 0x3200);
+    EXPECT_EQ(right_score, 12);
+}
+
+TEST(TestBoard, MatchesGameMoves)
+{
+    std::mt19937 gen(2);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const Board board = RandomBoard(gen);
+
+        for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            Game game;
+            UnpackGrid(board, game.GetGrid());
+            game.Move(dir);
+
+            ASSERT_EQ(MoveBoard(board, dir).board, PackGrid(game.GetGrid()));
+        }
+    }
+}
+
+TEST(TestBoard, Symmetries)
+{
+    std::mt19937 gen(3);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        const Board board = RandomBoard(gen);
+        const auto boards = Symmetries(board);
+
+        for (size_t row = 0; row < BOARD_SIZE; ++row)
+        {
+            for (size_t col = 0; col < BOARD_SIZE; ++col)
+            {
+                const auto cell = GetCell(board, row * BOARD_SIZE + col);
+                ASSERT_EQ(GetCell(FlipHorizontal(board), row * BOARD_SIZE + BOARD_SIZE - 1 - col), cell);
+                ASSERT_EQ(GetCell(FlipVertical(board), (BOARD_SIZE - 1 - row) * BOARD_SIZE + col), cell);
+            }
+        }
+
+        for (size_t symmetry = 0; symmetry < BOARD_SYMMETRIES; ++symmetry)
+        {
+            ASSERT_EQ(boards.at(symmetry), ApplySymmetry(board, symmetry));
+        }
+    }
+}
+
+TEST(TestBoard, CanonicalizeIsInvariant)
+{
+    std::mt19937 gen(4);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        const Board board = RandomBoard(gen);
+        const auto canonical = Canonicalize(board);
+
+        ASSERT_EQ(ApplySymmetry(board, canonical.symmetry), canonical.board);
+
+        for (const Board symmetric : Symmetries(board))
+        {
+            ASSERT_EQ(Canonicalize(symmetric).board, canonical.board);
+        }
+    }
+}
+
+TEST(TestBoard, SymmetricMoves)
+{
+    std::mt19937 gen(5);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        const Board board = RandomBoard(gen);
+
+        for (size_t symmetry = 0; symmetry < BOARD_SYMMETRIES; ++symmetry)
+        {
+            for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+            {
+                const auto mapped = ApplySymmetry(dir, symmetry);
+
+                ASSERT_EQ(MoveBoard(ApplySymmetry(board, symmetry), mapped).board,
+                          ApplySymmetry(MoveBoard(board, dir).board, symmetry));
+                ASSERT_EQ(InvertSymmetry(mapped, symmetry), dir);
+            }
+        }
+    }
+}
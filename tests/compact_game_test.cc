@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "../src/compact_game.h"
+
+TEST(TestCompactGame, StartSpawnsTwoTiles)
+{
+    CompactGame game(1);
+    EXPECT_EQ(game.State(), GameState::Startup);
+
+    game.Start();
+    EXPECT_EQ(game.State(), GameState::Playing);
+    EXPECT_EQ(CountEmpty(game.GetBoard()), 14);
+    EXPECT_EQ(game.Score(), 0);
+}
+
+TEST(TestCompactGame, SameSeedSameGame)
+{
+    CompactGame first(42);
+    CompactGame second(42);
+    first.Start();
+    second.Start();
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto dir = static_cast<Direction>(i % 4);
+        EXPECT_EQ(first.Move(dir), second.Move(dir));
+        EXPECT_EQ(first.GetBoard(), second.GetBoard());
+    }
+
+    EXPECT_EQ(first.Score(), second.Score());
+}
+
+TEST(TestCompactGame, MovesFollowTheBoardKernel)
+{
+    CompactGame game(7);
+    game.Start();
+
+    for (int i = 0; i < 1000 && game.State() == GameState::Playing; ++i)
+    {
+        const auto dir = static_cast<Direction>(i % 4);
+        const Board before = game.GetBoard();
+        const auto expected = MoveBoard(before, dir);
+        const auto score = game.Score();
+
+        if (game.Move(dir))
+        {
+            // the kernel's board plus one spawned 2 or 4
+            EXPECT_EQ(CountEmpty(game.GetBoard()), CountEmpty(expected.board) - 1);
+            EXPECT_EQ(TileSum(game.GetBoard()) - TileSum(expected.board) == 2 ||
+                          TileSum(game.GetBoard()) - TileSum(expected.board) == 4,
+                      true);
+            EXPECT_EQ(game.Score(), score + expected.score);
+        }
+        else
+        {
+            EXPECT_EQ(expected.board, before);
+            EXPECT_EQ(game.GetBoard(), before);
+        }
+    }
+
+    // cycling through the four directions always ends the game
+    EXPECT_NE(game.State(), GameState::Playing);
+    EXPECT_FALSE(game.Move(Direction::LEFT));
+}
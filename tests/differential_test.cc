@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include "../src/differential.h"
+
+// lets merged tiles merge again, so that 2 2 4 becomes 8 instead of 4 4
+auto ChainMergingMove(const Board board, const Direction dir) -> MoveResult
+{
+    const auto expected = MoveBoard(board, dir);
+
+    if (dir != Direction::LEFT)
+    {
+        return expected;
+    }
+
+    MoveResult result = {0, 0};
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        std::array<std::uint8_t, BOARD_SIZE> line = {};
+        size_t count = 0;
+
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            const auto exponent = GetCell(board, row * BOARD_SIZE + col);
+
+            if (exponent == 0)
+            {
+                continue;
+            }
+
+            if (count > 0 && line.at(count - 1) == exponent)
+            {
+                ++line.at(count - 1);
+                result.score += ExponentToValue(line.at(count - 1));
+
+                // the bug: the merged tile merges again with the tile before it
+                while (count > 1 && line.at(count - 2) == line.at(count - 1))
+                {
+                    --count;
+                    ++line.at(count - 1);
+                    result.score += ExponentToValue(line.at(count - 1));
+                }
+
+                continue;
+            }
+
+            line.at(count++) = exponent;
+        }
+
+        for (size_t col = 0; col < count; ++col)
+        {
+            result.board = SetCell(result.board, row * BOARD_SIZE + col, line.at(col));
+        }
+    }
+
+    return result;
+}
+
+TEST(TestDifferential, ReferenceFollowsGameRules)
+{
+    // 2 2 4 8 -> 4 4 8 0, scoring 4
+    const auto result = ReferenceMove(0x3211, Direction::LEFT);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->board, 0x0322);
+    EXPECT_EQ(result->score, 4);
+
+    // merging two 32768 tiles leaves the packed domain
+    EXPECT_FALSE(ReferenceMove(0xff, Direction::LEFT).has_value());
+}
+
+TEST(TestDifferential, EnginesMatchTheReference)
+{
+    for (const auto &engine : MoveEngines())
+    {
+        const auto report = RunDifferential(engine, 20000, 7);
+        EXPECT_EQ(report.cases, 20000);
+        EXPECT_GT(report.moves, 20000);
+        EXPECT_FALSE(report.counterexample.has_value()) << FormatCounterexample(*report.counterexample);
+    }
+}
+
+TEST(TestDifferential, FindsAndMinimizesDivergences)
+{
+    const MoveEngine broken = {"ChainMerging", ChainMergingMove};
+    const auto report = RunDifferential(broken, 100000, 7);
+    ASSERT_TRUE(report.counterexample.has_value());
+
+    const auto &counterexample = *report.counterexample;
+    EXPECT_EQ(counterexample.engine, "ChainMerging");
+    EXPECT_EQ(counterexample.dir, Direction::LEFT);
+
+    EXPECT_NE(counterexample.actual.board, counterexample.expected.board);
+
+    // three tiles in a row, e.g. 2 2 4, and no tile can be removed or lowered without losing the divergence
+    EXPECT_EQ(CountEmpty(counterexample.board), 13);
+
+    for (size_t cell = 0; cell < BOARD_CELLS; ++cell)
+    {
+        const auto exponent = GetCell(counterexample.board, cell);
+
+        if (exponent == 0)
+        {
+            continue;
+        }
+
+        for (const auto smaller : {std::uint8_t{0}, static_cast<std::uint8_t>(exponent - 1)})
+        {
+            const Board board = SetCell(counterexample.board, cell, smaller);
+            const auto expected = ReferenceMove(board, Direction::LEFT);
+            ASSERT_TRUE(expected.has_value());
+            EXPECT_EQ(ChainMergingMove(board, Direction::LEFT).board, expected->board);
+        }
+    }
+}
+
+TEST(TestDifferential, CheckCaseFollowsTheSteps)
+{
+    const MoveEngine broken = {"ChainMerging", ChainMergingMove};
+
+    // the spawns turn a lone 4 into 4 _ 2 2, which the broken engine chains into a 16 on the third move
+    DifferentialCase test_case;
+    test_case.start = 0x0002;
+    test_case.steps = {{Direction::UP, 2}, {Direction::UP, 3}, {Direction::LEFT, 15}};
+
+    std::uint64_t checked = 0;
+    EXPECT_FALSE(CheckCase(MoveEngines().front(), test_case, checked).has_value());
+    EXPECT_EQ(checked, 3);
+
+    checked = 0;
+    const auto counterexample = CheckCase(broken, test_case, checked);
+    ASSERT_TRUE(counterexample.has_value());
+    EXPECT_EQ(checked, 3);
+    EXPECT_EQ(counterexample->board, 0x1102);
+    EXPECT_EQ(counterexample->expected.board, 0x0022);
+    EXPECT_EQ(counterexample->actual.board, 0x0003);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "../src/frame_stats.h"
+
+TEST(TestCounters, CountEventAddsUp)
+{
+    const auto before = ReadCounter(Counter::TextureCreations);
+    CountEvent(Counter::TextureCreations);
+    CountEvent(Counter::TextureCreations, 4);
+
+    EXPECT_EQ(ReadCounter(Counter::TextureCreations), before + 5);
+    EXPECT_EQ(ReadCounters()[static_cast<size_t>(Counter::TextureCreations)], before + 5);
+    EXPECT_EQ(CounterName(Counter::SearchNodes), "search nodes");
+}
+
+TEST(TestFrameStats, EmptyStats)
+{
+    const FrameStats stats;
+    EXPECT_EQ(stats.Fps(), 0.0);
+    EXPECT_EQ(stats.FrameTimePercentile(0.99), 0.0);
+    EXPECT_EQ(stats.PerFrame(Counter::TextRasterizations), 0.0);
+}
+
+TEST(TestFrameStats, FrameTimes)
+{
+    FrameStats stats;
+
+    // 99 frames of 10 ms and one of 50 ms
+    for (int i = 0; i < 99; ++i)
+    {
+        stats.AddFrame(10'000'000, {});
+    }
+
+    stats.AddFrame(50'000'000, {});
+
+    EXPECT_NEAR(stats.Fps(), 100.0 / 1.04, 1e-9);
+    EXPECT_DOUBLE_EQ(stats.FrameTimePercentile(0.5), 10.0);
+    EXPECT_DOUBLE_EQ(stats.FrameTimePercentile(0.99), 10.0);
+    EXPECT_DOUBLE_EQ(stats.FrameTimePercentile(1.0), 50.0);
+}
+
+TEST(TestFrameStats, CounterRates)
+{
+    FrameStats stats({10, 0, 1000});
+    CounterValues counters = {10, 0, 1000};
+
+    // 4 rasterizations and 500 search nodes per 20 ms frame
+    for (int i = 0; i < 10; ++i)
+    {
+        counters[0] += 4;
+        counters[2] += 500;
+        stats.AddFrame(20'000'000, counters);
+    }
+
+    EXPECT_DOUBLE_EQ(stats.PerFrame(Counter::TextRasterizations), 4.0);
+    EXPECT_DOUBLE_EQ(stats.PerFrame(Counter::TextureCreations), 0.0);
+    EXPECT_DOUBLE_EQ(stats.PerSecond(Counter::SearchNodes), 25000.0);
+}
+
+TEST(TestFrameStats, OldFramesLeaveTheWindow)
+{
+    FrameStats stats;
+    CounterValues counters = {};
+
+    // a burst of rasterizations, then a whole window of quiet frames
+    counters[0] = 1000;
+    stats.AddFrame(100'000'000, counters);
+
+    for (size_t i = 0; i < FRAME_WINDOW; ++i)
+    {
+        counters[0] += 1;
+        stats.AddFrame(16'000'000, counters);
+    }
+
+    EXPECT_DOUBLE_EQ(stats.PerFrame(Counter::TextRasterizations), 1.0);
+    EXPECT_DOUBLE_EQ(stats.FrameTimePercentile(1.0), 16.0);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "../src/frame_writer.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+class FrameWriterTest : public ::testing::Test
+{
+  public:
+    std::filesystem::path dir;
+
+    void SetUp() override
+    {
+        dir = std::filesystem::temp_directory_path() / "c2048_frame_writer_test";
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+};
+
+TEST_F(FrameWriterTest, WritesEveryFrame)
+{
+    constexpr int frames = 12;
+    FrameWriter writer(dir, 3, 1);
+
+    for (int index = 0; index < frames; ++index)
+    {
+        CapturedFrame frame = {static_cast<std::uint64_t>(index), 8, 4, writer.Buffer(8 * 4 * 4)};
+        std::ranges::fill(frame.pixels, static_cast<std::uint8_t>(index));
+        writer.Submit(std::move(frame));
+    }
+
+    writer.Finish();
+    EXPECT_EQ(writer.Written(), frames);
+
+    for (std::uint64_t index = 0; index < frames; ++index)
+    {
+        std::ifstream in(FrameWriter::FramePath(dir, index), std::ios::binary);
+        std::array<char, 4> signature = {};
+        in.read(signature.data(), signature.size());
+
+        EXPECT_TRUE(in) << index;
+        EXPECT_EQ(std::string(signature.begin() + 1, signature.end()), "PNG");
+    }
+
+    EXPECT_EQ(FrameWriter::FramePath(dir, 42).filename(), "frame_000042.png");
+}
+
+TEST_F(FrameWriterTest, BuffersHaveTheRequestedSize)
+{
+    FrameWriter writer(dir, 1, 4);
+
+    writer.Submit({0, 2, 2, writer.Buffer(2 * 2 * 4)});
+    writer.Finish();
+
+    // recycled from the written frame
+    EXPECT_EQ(writer.Buffer(100).size(), 100);
+    EXPECT_EQ(writer.Buffer(8).size(), 8);
+}
+
+TEST_F(FrameWriterTest, FailuresSurfaceInFinish)
+{
+    FrameWriter writer(dir, 2, 4);
+
+    // pixels that do not cover the frame
+    writer.Submit({0, 16, 16, writer.Buffer(4)});
+    writer.Submit({1, 1, 1, writer.Buffer(4)});
+
+    EXPECT_THROW(writer.Finish(), std::runtime_error);
+    EXPECT_EQ(writer.Written(), 1);
+    // reported once
+    EXPECT_NO_THROW(writer.Finish());
+}
+
+TEST_F(FrameWriterTest, DestructionWritesWhatIsPending)
+{
+    {
+        FrameWriter writer(dir, 1, 8);
+
+        for (std::uint64_t index = 0; index < 8; ++index)
+        {
+            writer.Submit({index, 64, 64, writer.Buffer(64 * 64 * 4)});
+        }
+    }
+
+    EXPECT_TRUE(std::filesystem::exists(FrameWriter::FramePath(dir, 7)));
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include "../src/game_stats.h"
+#include "../src/mapped_file.h"
+
+#include <fstream>
+
+// plays random moves until the game is over, returns what a replay has to find
+auto PlayRandomGame(std::mt19937 &gen, GameRecord &record) -> ReplayResult
+{
+    ReplayResult expected;
+    Board board = SpawnRandom(SpawnRandom(0, gen), gen);
+    record = {board, {}};
+
+    std::uniform_int_distribution<int> dir_dist(0, 3);
+
+    while (true)
+    {
+        bool has_moves = false;
+
+        for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            has_moves = has_moves || MoveBoard(board, dir).board != board;
+        }
+
+        if (!has_moves)
+        {
+            break;
+        }
+
+        const auto dir = static_cast<Direction>(dir_dist(gen));
+        const auto [after, score] = MoveBoard(board, dir);
+
+        if (after == board)
+        {
+            continue;
+        }
+
+        board = SpawnRandom(after, gen);
+        record.Add(dir, after, board);
+
+        expected.score += score;
+        ++expected.moves;
+        ++expected.directions.at(static_cast<size_t>(dir));
+    }
+
+    expected.max_exponent = MaxExponent(board);
+    return expected;
+}
+
+class GameRecordTest : public ::testing::Test
+{
+  public:
+    std::filesystem::path dir;
+
+    void SetUp() override
+    {
+        dir = std::filesystem::temp_directory_path() / "c2048_game_record_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    // writes `games` random games, returns their aggregates
+    auto WriteGames(const std::filesystem::path &path, const int games, const std::uint32_t seed) const -> GameStats
+    {
+        std::mt19937 gen(seed);
+        GameRecordWriter writer(path);
+        GameRecord record;
+        GameStats expected;
+
+        for (int game = 0; game < games; ++game)
+        {
+            expected.Add(PlayRandomGame(gen, record));
+            writer.Write(record);
+        }
+
+        writer.Flush();
+        return expected;
+    }
+};
+
+TEST_F(GameRecordTest, WriteReadAndReplay)
+{
+    std::mt19937 gen(5);
+    std::vector<GameRecord> records(3);
+    std::vector<ReplayResult> expected;
+
+    {
+        GameRecordWriter writer(dir / "games.rec");
+
+        for (auto &record : records)
+        {
+            expected.push_back(PlayRandomGame(gen, record));
+            writer.Write(record);
+        }
+
+        writer.Flush();
+    }
+
+    const MappedFile file(dir / "games.rec");
+    GameRecordReader reader(file.Bytes());
+    GameRecordView view;
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        ASSERT_TRUE(reader.Next(view));
+        EXPECT_EQ(view.start, records.at(i).start);
+        EXPECT_TRUE(std::ranges::equal(view.steps, records.at(i).steps));
+
+        const auto replayed = ReplayRecord(view);
+        EXPECT_TRUE(replayed.valid);
+        EXPECT_EQ(replayed.score, expected.at(i).score);
+        EXPECT_EQ(replayed.moves, expected.at(i).moves);
+        EXPECT_EQ(replayed.max_exponent, expected.at(i).max_exponent);
+        EXPECT_EQ(replayed.directions, expected.at(i).directions);
+    }
+
+    EXPECT_FALSE(reader.Next(view));
+}
+
+TEST_F(GameRecordTest, ReplayRejectsBrokenRules)
+{
+    // a 2 in the corner cannot move left
+    GameRecord record;
+    record.start = 0x1;
+    record.steps = {static_cast<std::uint8_t>(Direction::LEFT)};
+    EXPECT_FALSE(ReplayRecord({record.start, record.steps}).valid);
+
+    // moving right frees cell 0 but not cell 3, where the tile lands
+    record.steps = {static_cast<std::uint8_t>(static_cast<std::uint8_t>(Direction::RIGHT) | 3 << 2)};
+    EXPECT_FALSE(ReplayRecord({record.start, record.steps}).valid);
+
+    record.steps = {static_cast<std::uint8_t>(Direction::RIGHT)};
+    const auto replayed = ReplayRecord({record.start, record.steps});
+    EXPECT_TRUE(replayed.valid);
+    EXPECT_EQ(replayed.moves, 1);
+}
+
+TEST_F(GameRecordTest, ApplyStepGivesTheNextBoard)
+{
+    // the 2 slides to cell 3, a 4 spawns in cell 0
+    const auto step = static_cast<std::uint8_t>(static_cast<std::uint8_t>(Direction::RIGHT) | 0x40);
+    const auto next = ApplyStep(0x1, step);
+
+    ASSERT_TRUE(next.has_value());
+    EXPECT_EQ(next->board, 0x1002);
+    EXPECT_EQ(next->score, 0);
+    EXPECT_FALSE(ApplyStep(0x1, static_cast<std::uint8_t>(Direction::LEFT)).has_value());
+}
+
+TEST_F(GameRecordTest, RejectsForeignFiles)
+{
+    std::ofstream(dir / "foreign.rec") << "not a record file at all";
+
+    const MappedFile file(dir / "foreign.rec");
+    EXPECT_THROW(GameRecordReader(file.Bytes()), std::runtime_error);
+    EXPECT_THROW((void)CollectGameStats({dir / "foreign.rec"}, 2), std::runtime_error);
+}
+
+TEST_F(GameRecordTest, ParallelStatsMatchSerialOnes)
+{
+    std::filesystem::create_directories(dir / "day");
+    auto expected = WriteGames(dir / "day" / "a.rec", 5000, 1);
+    expected.Merge(WriteGames(dir / "b.rec", 300, 2));
+    std::ofstream(dir / "notes.txt") << "ignored";
+
+    const auto files = FindRecordFiles({dir});
+    ASSERT_EQ(files.size(), 2);
+
+    const auto stats = CollectGameStats(files, 3);
+    EXPECT_EQ(stats.games, 5300);
+    EXPECT_EQ(stats.invalid, 0);
+    EXPECT_EQ(stats.moves, expected.moves);
+    EXPECT_EQ(stats.directions, expected.directions);
+    EXPECT_EQ(stats.max_tiles, expected.max_tiles);
+    EXPECT_EQ(Percentile(stats.scores, 50), Percentile(expected.scores, 50));
+    EXPECT_EQ(Percentile(stats.lengths, 99), Percentile(expected.lengths, 99));
+    EXPECT_DOUBLE_EQ(stats.ReachRate(0), 1.0);
+}
+
+TEST_F(GameRecordTest, TruncatedRecordIsInvalid)
+{
+    WriteGames(dir / "games.rec", 10, 3);
+    std::filesystem::resize_file(dir / "games.rec", std::filesystem::file_size(dir / "games.rec") - 1);
+
+    const auto stats = CollectGameStats({dir / "games.rec"}, 1);
+    EXPECT_EQ(stats.games, 9);
+    EXPECT_EQ(stats.invalid, 1);
+}
+
+TEST(TestGameStats, Percentile)
+{
+    const std::vector<std::uint64_t> values = {5, 1, 4, 2, 3};
+    EXPECT_EQ(Percentile(values, 0), 1);
+    EXPECT_EQ(Percentile(values, 50), 3);
+    EXPECT_EQ(Percentile(values, 90), 5);
+    EXPECT_EQ(Percentile(values, 100), 5);
+    EXPECT_EQ(Percentile(std::vector<std::uint64_t>(), 50), 0);
+}
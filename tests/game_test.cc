@@ -364,3 +364,60 @@ TEST(TestSlideCol, SlideColumnUpComplex)
     game.Move(Direction::UP);
     AssertCol(game, 0, {4, 8, 0, 0});
 }
+
+TEST(TestScore, MergesBeyondByteRange)
+{
+    Game game;
+    InitRow(game, 0, {256, 256, 0, 0});
+    game.Move(Direction::LEFT);
+    AssertRow(game, 0, {512, 0, 0, 0});
+    EXPECT_EQ(game.Score(), 512);
+}
+
+TEST(TestScore, ColumnMergesAddUp)
+{
+    Game game;
+    InitCol(game, 0, {2, 2, 0, 0});
+    InitCol(game, 1, {4, 4, 0, 0});
+    game.Move(Direction::UP);
+    EXPECT_EQ(game.Score(), 12);
+}
+
+TEST(TestScore, LargestTiles)
+{
+    Game game;
+    InitRow(game, 0, {65536, 65536, 0, 0});
+    game.Move(Direction::RIGHT);
+    AssertRow(game, 0, {0, 0, 0, MAX_TILE});
+    EXPECT_EQ(game.Score(), MAX_TILE);
+}
+
+TEST(TestEndless, ContinueAfterVictory)
+{
+    Game game(1);
+    game.Start();
+    game.GetGrid().Init();
+    InitRow(game, 0, {1024, 1024, 0, 0});
+    game.Move(Direction::LEFT);
+    EXPECT_TRUE(game.Update());
+    EXPECT_EQ(game.State(), GameState::Victory);
+
+    game.Continue();
+    EXPECT_EQ(game.State(), GameState::Playing);
+    EXPECT_TRUE(game.Endless());
+
+    // the win tile is still on the board, it no longer ends the game
+    EXPECT_FALSE(game.Update());
+    EXPECT_EQ(game.State(), GameState::Playing);
+
+    game.Reset();
+    EXPECT_FALSE(game.Endless());
+}
+
+TEST(TestEndless, ContinueOnlyAfterVictory)
+{
+    Game game(1);
+    game.Start();
+    game.Continue();
+    EXPECT_FALSE(game.Endless());
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "../src/heuristic.h"
+
+TEST(TestHeuristic, BoardIsTheSumOfRowsAndColumns)
+{
+    const HeuristicEvaluator evaluator;
+    const Board board = 0x0000'0121'0312'2431;
+    const Board transposed = Transpose(board);
+
+    float expected = 0;
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        expected += evaluator.RowScore(GetRow(board, row)) + evaluator.RowScore(GetRow(transposed, row));
+    }
+
+    EXPECT_FLOAT_EQ(evaluator(board), expected);
+    EXPECT_FLOAT_EQ(EvaluateHeuristic(board), expected);
+}
+
+TEST(TestHeuristic, SymmetricBoardsScoreTheSame)
+{
+    const HeuristicEvaluator evaluator;
+    const Board board = 0x0000'0121'0312'2431;
+
+    EXPECT_FLOAT_EQ(evaluator(Transpose(board)), evaluator(board));
+    EXPECT_FLOAT_EQ(evaluator(FlipHorizontal(board)), evaluator(board));
+    EXPECT_FLOAT_EQ(evaluator(FlipVertical(board)), evaluator(board));
+}
+
+TEST(TestHeuristic, TermsFollowTheirWeights)
+{
+    HeuristicWeights weights;
+    weights.alive = 1;
+    weights.empty = 0;
+    weights.merges = 0;
+    weights.monotonicity = 0;
+    weights.smoothness = 0;
+    weights.corner = 0;
+    EXPECT_FLOAT_EQ(HeuristicEvaluator(weights)(0x1234'0000'0000'0000), 8.0f);
+
+    weights.empty = 1;
+    EXPECT_FLOAT_EQ(HeuristicEvaluator(weights).RowScore(0x0101), 3.0f);
+
+    weights.empty = 0;
+    weights.merges = 1;
+    // a gap does not stop a merge
+    EXPECT_FLOAT_EQ(HeuristicEvaluator(weights).RowScore(0x1011), 3.0f);
+
+    weights.merges = 0;
+    weights.smoothness = 1;
+    EXPECT_FLOAT_EQ(HeuristicEvaluator(weights).RowScore(0x0513), 1.0f - 2 - 4);
+
+    weights.smoothness = 0;
+    weights.corner = 1;
+    EXPECT_FLOAT_EQ(HeuristicEvaluator(weights).RowScore(0x3002), 1.0f + 4 + 9);
+}
+
+TEST(TestHeuristic, LiveBoardsScoreAboveALostOne)
+{
+    const HeuristicEvaluator evaluator;
+
+    // every row and column alternates between 2^15 and empty cells: the monotonicity penalty alone is in the millions
+    const Board checkers = 0x0f0f'f0f0'0f0f'f0f0;
+    ASSERT_LT(4 * evaluator.RowScore(0x0f0f) + 4 * evaluator.RowScore(0xf0f0), 0.0f);
+
+    EXPECT_FLOAT_EQ(evaluator(checkers), HeuristicEvaluator::LIVE_FLOOR);
+    EXPECT_GT(EvaluateHeuristic(checkers), 0.0f);
+}
+
+TEST(TestHeuristic, PrefersMonotoneRows)
+{
+    const HeuristicEvaluator evaluator;
+
+    // same tiles, in order and zigzagging
+    EXPECT_GT(evaluator.RowScore(0x4321), evaluator.RowScore(0x3412));
+    EXPECT_FLOAT_EQ(evaluator.RowScore(0x4321), evaluator.RowScore(0x1234));
+}
+
+TEST(TestHeuristic, PrefersEmptyCellsAndMerges)
+{
+    const HeuristicEvaluator evaluator;
+
+    EXPECT_GT(evaluator.RowScore(0x0021), evaluator.RowScore(0x3121));
+    EXPECT_GT(evaluator.RowScore(0x0022), evaluator.RowScore(0x0023));
+}
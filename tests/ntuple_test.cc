@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "../src/td_trainer.h"
+
+auto SmallNetwork() -> NTupleNetwork
+{
+    return NTupleNetwork({{0, 1, 2, 3}, {4, 5, 6, 7}, {0, 1, 4, 5}});
+}
+
+auto MirrorBoard(const Board board) -> Board
+{
+    Board mirrored = 0;
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            mirrored = SetCell(mirrored, row * BOARD_SIZE + BOARD_SIZE - 1 - col, GetCell(board, row * BOARD_SIZE + col));
+        }
+    }
+
+    return mirrored;
+}
+
+TEST(TestNTuple, InvalidTuples)
+{
+    ASSERT_THROW(NTupleNetwork(std::vector<TupleCells>{TupleCells{}}), std::invalid_argument);
+    ASSERT_THROW(NTupleNetwork({{0, 1, 2, 3, 4, 5, 6}}), std::invalid_argument);
+    ASSERT_THROW(NTupleNetwork({{0, 16}}), std::invalid_argument);
+}
+
+TEST(TestNTuple, UpdateMovesValue)
+{
+    auto network = SmallNetwork();
+    const Board board = 0x0000'0000'0021'3211;
+
+    EXPECT_FLOAT_EQ(network.Evaluate(board), 0.0f);
+    network.Update(board, 12.0f);
+
+    // symmetric samples of the same board may share weights, so the value can move further than asked
+    EXPECT_GE(network.Evaluate(board), 12.0f);
+    EXPECT_FLOAT_EQ(network.Evaluate(0x9999'9999'9999'9999), 0.0f);
+}
+
+TEST(TestNTuple, SymmetricBoardsShareWeights)
+{
+    auto network = SmallNetwork();
+    const Board board = 0x0000'0100'0021'3211;
+    network.Update(board, 5.0f);
+
+    const float value = network.Evaluate(board);
+    EXPECT_FLOAT_EQ(network.Evaluate(Transpose(board)), value);
+    EXPECT_FLOAT_EQ(network.Evaluate(MirrorBoard(board)), value);
+    EXPECT_FLOAT_EQ(network.Evaluate(MirrorBoard(Transpose(board))), value);
+}
+
+TEST(TestNTuple, SaveAndLoad)
+{
+    const auto path = std::filesystem::temp_directory_path() / "c2048_ntuple_test.nt";
+
+    auto network = SmallNetwork();
+    const Board board = 0x1234'0000'4321'0000;
+    network.Update(board, 3.5f);
+    network.Save(path);
+
+    const auto loaded = NTupleNetwork::Load(path);
+    EXPECT_EQ(loaded.Tuples(), network.Tuples());
+    EXPECT_FLOAT_EQ(loaded.Evaluate(board), network.Evaluate(board));
+
+    std::filesystem::remove(path);
+}
+
+TEST(TestNTuple, TrainingLearnsValues)
+{
+    auto network = SmallNetwork();
+
+    TrainOptions options;
+    options.games = 200;
+    options.threads = 2;
+    options.report_every = 100;
+
+    std::uint64_t reports = 0;
+    double mean_score = 0;
+
+    TrainNetwork(network, options, [&](const TrainProgress &progress) {
+        ++reports;
+        mean_score = progress.mean_score;
+    });
+
+    EXPECT_GE(reports, 2);
+    EXPECT_GT(mean_score, 0);
+    EXPECT_NE(network.Evaluate(0x0000'0000'0000'0011), 0.0f);
+}
+
+TEST(TestNTuple, OverlappingCheckpointsAreWholeFiles)
+{
+    const auto path = std::filesystem::temp_directory_path() / "c2048_ntuple_checkpoint.nt";
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    // a checkpoint after every game, from four threads, overlaps saves as often as it can
+    auto network = SmallNetwork();
+    TrainOptions options;
+    options.games = 400;
+    options.threads = 4;
+    options.checkpoint_every = 1;
+    options.checkpoint_path = path;
+
+    testing::internal::CaptureStderr();
+    TrainNetwork(network, options, nullptr);
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+
+    const auto loaded = NTupleNetwork::Load(path);
+    EXPECT_EQ(loaded.Tuples(), network.Tuples());
+    EXPECT_FALSE(std::filesystem::exists(tmp_path));
+
+    std::filesystem::remove(path);
+}
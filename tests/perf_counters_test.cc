@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "../src/perf_counters.h"
+
+TEST(TestPerfCounters, Ratios)
+{
+    PerfReading reading;
+    reading.values[static_cast<size_t>(PerfEvent::Cycles)] = 1000;
+    reading.values[static_cast<size_t>(PerfEvent::Instructions)] = 2500;
+
+    EXPECT_DOUBLE_EQ(*reading.Ratio(PerfEvent::Instructions, PerfEvent::Cycles), 2.5);
+    EXPECT_DOUBLE_EQ(*reading.PerOperation(PerfEvent::Instructions, 100), 25.0);
+
+    // missing counters and empty regions have no ratio
+    EXPECT_FALSE(reading.Ratio(PerfEvent::BranchMisses, PerfEvent::Cycles).has_value());
+    EXPECT_FALSE(reading.PerOperation(PerfEvent::LlcMisses, 100).has_value());
+    EXPECT_FALSE(reading.PerOperation(PerfEvent::Cycles, 0).has_value());
+}
+
+TEST(TestPerfCounters, MeasuresARegionWhenAvailable)
+{
+    PerfCounters counters;
+    counters.Start();
+
+    volatile std::uint64_t sum = 0;
+
+    for (std::uint64_t i = 0; i < 100000; ++i)
+    {
+        sum = sum + i;
+    }
+
+    const auto reading = counters.Stop();
+
+    if (!counters.Available())
+    {
+        // without a PMU nothing is reported, and measuring still works
+        for (const auto &value : reading.values)
+        {
+            EXPECT_FALSE(value.has_value());
+        }
+
+        GTEST_SKIP() << "hardware counters are not available";
+    }
+
+    if (const auto instructions = reading.Get(PerfEvent::Instructions))
+    {
+        EXPECT_GT(*instructions, 100000);
+    }
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include "../src/png.h"
+
+#include <array>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+
+// inflates the single fixed-code block that ZlibCompress writes, enough to check what it encodes
+static auto InflateFixed(const std::span<const std::uint8_t> stream) -> std::vector<std::uint8_t>
+{
+    constexpr std::array<int, 29> length_bases = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    // past the zlib header
+    size_t bit = 16;
+
+    const auto read = [&](const int count) {
+        int value = 0;
+
+        for (int i = 0; i < count; ++i, ++bit)
+        {
+            value |= ((stream[bit / 8] >> (bit % 8)) & 1) << i;
+        }
+
+        return value;
+    };
+    const auto read_code = [&](const int count) {
+        int code = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            code = (code << 1) | read(1);
+        }
+
+        return code;
+    };
+
+    // final block, fixed codes
+    EXPECT_EQ(read(3), 0b011);
+
+    std::vector<std::uint8_t> out;
+
+    while (true)
+    {
+        int code = read_code(7);
+        int symbol = 256 + code;
+
+        if (code > 0x17)
+        {
+            code = (code << 1) | read(1);
+            symbol = code <= 0xbf ? code - 0x30 : code <= 0xc7 ? code - 0xc0 + 280 : -1;
+
+            if (symbol < 0)
+            {
+                symbol = ((code << 1) | read(1)) - 0x190 + 144;
+            }
+        }
+
+        if (symbol == 256)
+        {
+            return out;
+        }
+
+        if (symbol < 256)
+        {
+            out.push_back(static_cast<std::uint8_t>(symbol));
+            continue;
+        }
+
+        const auto length_code = static_cast<size_t>(symbol - 257);
+        const int length_extra = length_code < 8 || length_code == 28 ? 0 : static_cast<int>(length_code - 4) / 4;
+        const int length = length_bases.at(length_code) + read(length_extra);
+        const int distance_code = read_code(5);
+        const int distance_extra = distance_code < 4 ? 0 : distance_code / 2 - 1;
+        const int distance_base =
+            distance_code < 4 ? distance_code + 1 : ((2 + distance_code % 2) << distance_extra) + 1;
+        const auto distance = static_cast<size_t>(distance_base + read(distance_extra));
+
+        for (int i = 0; i < length; ++i)
+        {
+            out.push_back(out.at(out.size() - distance));
+        }
+    }
+}
+
+static auto ReadBigEndian(const std::span<const std::uint8_t> bytes, const size_t offset) -> std::uint32_t
+{
+    return std::uint32_t{bytes[offset]} << 24 | std::uint32_t{bytes[offset + 1]} << 16 |
+           std::uint32_t{bytes[offset + 2]} << 8 | std::uint32_t{bytes[offset + 3]};
+}
+
+TEST(TestPng, Crc32CheckValue)
+{
+    constexpr std::string_view check = "123456789";
+    const auto bytes = std::span(reinterpret_cast<const std::uint8_t *>(check.data()), check.size());
+
+    EXPECT_EQ(Crc32(bytes), 0xcbf43926U);
+    // piecewise sums give the same value
+    EXPECT_EQ(Crc32(bytes.subspan(4), Crc32(bytes.first(4))), 0xcbf43926U);
+}
+
+TEST(TestPng, CompressedStreamInflatesBack)
+{
+    std::mt19937 gen(7);
+    std::vector<std::uint8_t> bytes;
+
+    // runs, repeats farther than a match can reach and noise
+    for (int block = 0; block < 400; ++block)
+    {
+        const auto value = static_cast<std::uint8_t>(gen() % 5);
+        bytes.insert(bytes.end(), gen() % 300, value);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(gen()));
+        }
+    }
+
+    const auto stream = ZlibCompress(bytes);
+
+    EXPECT_EQ(stream[0], 0x78);
+    EXPECT_EQ(InflateFixed(stream), bytes);
+    EXPECT_LT(stream.size(), bytes.size() / 2);
+
+    // Adler-32 of the uncompressed bytes closes the stream
+    std::uint32_t a = 1;
+    std::uint32_t b = 0;
+
+    for (const auto byte : bytes)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    EXPECT_EQ(ReadBigEndian(stream, stream.size() - 4), (b << 16) | a);
+}
+
+TEST(TestPng, EmptyInputCompresses)
+{
+    const auto stream = ZlibCompress({});
+
+    EXPECT_TRUE(InflateFixed(stream).empty());
+    EXPECT_EQ(ReadBigEndian(stream, stream.size() - 4), 1U);
+}
+
+TEST(TestPng, ChunksOfAFlatImage)
+{
+    constexpr int width = 64;
+    constexpr int height = 32;
+    // rows padded to a larger pitch, like those of a surface
+    constexpr size_t pitch = width * 4 + 16;
+    std::vector<std::uint8_t> pixels(pitch * height);
+
+    for (size_t row = 0; row < height; ++row)
+    {
+        for (size_t col = 0; col < width; ++col)
+        {
+            const std::array<std::uint8_t, 4> color = {0xbb, 0xad, 0xa0, 0xff};
+            std::ranges::copy(color, pixels.begin() + static_cast<std::ptrdiff_t>(row * pitch + col * 4));
+        }
+    }
+
+    const auto png = EncodePng(pixels, width, height, pitch);
+    const std::array<std::uint8_t, 8> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    ASSERT_TRUE(std::equal(signature.begin(), signature.end(), png.begin()));
+
+    std::vector<std::string> types;
+    std::vector<std::uint8_t> filtered;
+    size_t offset = signature.size();
+
+    while (offset < png.size())
+    {
+        const auto length = ReadBigEndian(png, offset);
+        const auto chunk = std::span(png).subspan(offset + 4, length + 4);
+        const std::string type(chunk.begin(), chunk.begin() + 4);
+
+        EXPECT_EQ(ReadBigEndian(png, offset + 8 + length), Crc32(chunk)) << type;
+        types.push_back(type);
+
+        if (type == "IHDR")
+        {
+            EXPECT_EQ(ReadBigEndian(png, offset + 8), width);
+            EXPECT_EQ(ReadBigEndian(png, offset + 12), height);
+        }
+        else if (type == "IDAT")
+        {
+            filtered = InflateFixed(chunk.subspan(4));
+        }
+
+        offset += 12 + length;
+    }
+
+    EXPECT_EQ(types, (std::vector<std::string>{"IHDR", "IDAT", "IEND"}));
+    ASSERT_EQ(filtered.size(), static_cast<size_t>(height) * (width * 4 + 1));
+    // the Sub filter leaves the first pixel of a row and zeros after it
+    EXPECT_EQ(filtered[0], 1);
+    EXPECT_EQ(filtered[1], 0xbb);
+    EXPECT_EQ(filtered[5], 0);
+    EXPECT_LT(png.size(), pixels.size() / 20);
+}
+
+TEST(TestPng, PixelsMustCoverTheImage)
+{
+    const std::vector<std::uint8_t> pixels(4 * 4 * 4);
+
+    EXPECT_NO_THROW(EncodePng(pixels, 4, 4, 16));
+    EXPECT_THROW(EncodePng(pixels, 4, 5, 16), std::invalid_argument);
+    EXPECT_THROW(EncodePng(pixels, 4, 4, 8), std::invalid_argument);
+    EXPECT_THROW(EncodePng(pixels, 0, 4, 16), std::invalid_argument);
+}
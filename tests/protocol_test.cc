@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "../src/protocol.h"
+
+#include <stdexcept>
+
+TEST(TestProtocol, PositionAndState)
+{
+    EngineProtocol protocol(1);
+
+    EXPECT_EQ(protocol.Execute("position 0000000000000011 8"), "state 0000000000000011 8 playing");
+    EXPECT_EQ(protocol.Execute("state"), "state 0000000000000011 8 playing");
+    EXPECT_EQ(protocol.GetGame().GetGrid().GetTile(0, 0).value, 2);
+    EXPECT_EQ(protocol.GetGame().GetGrid().GetTile(0, 1).value, 2);
+
+    // no empty cell and no equal neighbours
+    EXPECT_EQ(protocol.Execute("position 1212212112122121"), "state 1212212112122121 0 gameover");
+}
+
+TEST(TestProtocol, LegalMoves)
+{
+    EngineProtocol protocol(1);
+    protocol.Execute("position 0000000000000001");
+    EXPECT_EQ(protocol.Execute("legal"), "legal dr");
+
+    protocol.Execute("position 1212212112122121");
+    EXPECT_EQ(protocol.Execute("legal"), "legal -");
+}
+
+TEST(TestProtocol, MoveDoesNotSpawn)
+{
+    EngineProtocol protocol(1);
+    protocol.Execute("position 0000000000000011");
+
+    EXPECT_EQ(protocol.Execute("move l"), "moved 4");
+    EXPECT_EQ(protocol.Execute("state"), "state 0000000000000002 4 playing");
+    EXPECT_EQ(protocol.Execute("move l"), "illegal");
+
+    const auto spawned = protocol.Execute("spawn");
+    EXPECT_NE(spawned, "state 0000000000000002 4 playing");
+}
+
+TEST(TestProtocol, LargestTilesDoNotMerge)
+{
+    EngineProtocol protocol(1);
+
+    // two 2^15 tiles do not merge on a packed board, the move only slides the 2 below them
+    protocol.Execute("position 00000000001001ff");
+    EXPECT_EQ(protocol.Execute("move l"), "moved 0");
+    EXPECT_EQ(protocol.Execute("state"), "state 00000000000101ff 0 playing");
+    EXPECT_EQ(protocol.Execute("hash").substr(0, 5), "hash ");
+
+    // nothing else moves, so neither does the pair
+    protocol.Execute("position 00000000000000ff");
+    EXPECT_EQ(protocol.Execute("legal"), "legal dr");
+    EXPECT_EQ(protocol.Execute("move l"), "illegal");
+    EXPECT_TRUE(protocol.Execute("play l").starts_with("played 0 00000000000000ff "));
+}
+
+TEST(TestProtocol, PlayAppliesABatch)
+{
+    EngineProtocol protocol(7);
+    protocol.Execute("new");
+
+    const auto reply = protocol.Execute("play lrlrlrlrudud");
+    EXPECT_TRUE(reply.starts_with("played "));
+
+    // an illegal move stops the batch
+    protocol.Execute("position 0000000000000001");
+    EXPECT_TRUE(protocol.Execute("play ld").starts_with("played 0 "));
+}
+
+TEST(TestProtocol, SeedsAreReproducible)
+{
+    EngineProtocol first(1);
+    EngineProtocol second(2);
+
+    EXPECT_EQ(first.Execute("new 42"), second.Execute("new 42"));
+    EXPECT_EQ(first.Execute("play lurdlurd"), second.Execute("play lurdlurd"));
+}
+
+TEST(TestProtocol, HashIsSymmetric)
+{
+    EngineProtocol protocol(1);
+
+    protocol.Execute("position 0000000000000001");
+    const auto corner = protocol.Execute("hash");
+    protocol.Execute("position 1000000000000000");
+    EXPECT_EQ(protocol.Execute("hash"), corner);
+}
+
+TEST(TestProtocol, MalformedCommands)
+{
+    EngineProtocol protocol(1);
+    protocol.Execute("position 0000000000000011");
+
+    EXPECT_THROW(protocol.Execute(""), std::invalid_argument);
+    EXPECT_THROW(protocol.Execute("jump"), std::invalid_argument);
+    EXPECT_THROW(protocol.Execute("move x"), std::invalid_argument);
+    EXPECT_THROW(protocol.Execute("position 12zz"), std::invalid_argument);
+    // the batch is validated before it is applied
+    EXPECT_THROW(protocol.Execute("play lx"), std::invalid_argument);
+    EXPECT_EQ(protocol.Execute("state"), "state 0000000000000011 0 playing");
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include "../src/compact_game.h"
+#include "../src/rules.h"
+
+#include <random>
+
+TEST(TestRules, ClassicKernelMatchesMoveBoard)
+{
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> exponent_dist(0, 4);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        Board board = 0;
+
+        for (size_t cell = 0; cell < BOARD_CELLS; ++cell)
+        {
+            board = SetCell(board, cell, static_cast<std::uint8_t>(exponent_dist(gen)));
+        }
+
+        for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+        {
+            const auto expected = MoveBoard(board, dir);
+            const auto actual = RuleKernel<ClassicRules>::Move(board, dir);
+            EXPECT_EQ(actual.board, expected.board);
+            EXPECT_EQ(actual.score, expected.score);
+        }
+    }
+}
+
+TEST(TestRules, ClassicKernelSpawnsLikeSpawnRandom)
+{
+    CompactRng first(11);
+    CompactRng second(11);
+    Board board = 0;
+
+    for (size_t i = 0; i < BOARD_CELLS; ++i)
+    {
+        const auto expected = SpawnRandom(board, first);
+        board = RuleKernel<ClassicRules>::Spawn(board, second);
+        EXPECT_EQ(board, expected);
+    }
+}
+
+TEST(TestRules, FibonacciMergesNeighbours)
+{
+    using Kernel = RuleKernel<FibonacciRules>;
+
+    EXPECT_EQ(FibonacciRules::Value(1), 1);
+    EXPECT_EQ(FibonacciRules::Value(2), 2);
+    EXPECT_EQ(FibonacciRules::Value(5), 8);
+    EXPECT_EQ(FibonacciRules::Value(FibonacciRules::WIN_CODE), 610);
+
+    // 1 1 -> 2, then 3 5 -> 8
+    const auto ones = Kernel::Move(0x0011, Direction::LEFT);
+    EXPECT_EQ(ones.board, 0x0002);
+    EXPECT_EQ(ones.score, 2);
+
+    const auto three_five = Kernel::Move(0x0043, Direction::LEFT);
+    EXPECT_EQ(three_five.board, 0x0005);
+    EXPECT_EQ(three_five.score, 8);
+
+    // 2 and 2 are not neighbours of the sequence, 2 and 8 neither
+    EXPECT_EQ(Kernel::Move(0x0022, Direction::LEFT).board, 0x0022);
+    EXPECT_EQ(Kernel::Move(0x0052, Direction::LEFT).board, 0x0052);
+
+    // 1 2 3 merges 1 and 2 when moving left, but 3 and 2 when moving right
+    const auto left = Kernel::Move(0x0321, Direction::LEFT);
+    EXPECT_EQ(left.board, 0x0033);
+    EXPECT_EQ(left.score, 3);
+
+    const auto right = Kernel::Move(0x0321, Direction::RIGHT);
+    EXPECT_EQ(right.board, 0x4100);
+    EXPECT_EQ(right.score, 5);
+
+    // the same column moved up and down
+    const auto up = Kernel::Move(0x0000'0003'0002'0001, Direction::UP);
+    EXPECT_EQ(up.board, 0x0000'0000'0003'0003);
+    EXPECT_EQ(up.score, 3);
+
+    const auto down = Kernel::Move(0x0000'0003'0002'0001, Direction::DOWN);
+    EXPECT_EQ(down.board, 0x0004'0001'0000'0000);
+    EXPECT_EQ(down.score, 5);
+}
+
+TEST(TestRules, ThreesMergesOneAndTwo)
+{
+    using Kernel = RuleKernel<ThreesRules>;
+
+    EXPECT_EQ(ThreesRules::Value(3), 3);
+    EXPECT_EQ(ThreesRules::Value(4), 6);
+    EXPECT_EQ(ThreesRules::Value(ThreesRules::WIN_CODE), 768);
+
+    const auto one_two = Kernel::Move(0x0021, Direction::LEFT);
+    EXPECT_EQ(one_two.board, 0x0003);
+    EXPECT_EQ(one_two.score, 3);
+
+    // 1 1 and 2 2 stay, 3 3 makes 6
+    EXPECT_EQ(Kernel::Move(0x0011, Direction::LEFT).board, 0x0011);
+    EXPECT_EQ(Kernel::Move(0x0022, Direction::LEFT).board, 0x0022);
+    EXPECT_EQ(Kernel::Move(0x0033, Direction::LEFT).board, 0x0004);
+}
+
+TEST(TestRules, BlockersSplitRows)
+{
+    using Kernel = RuleKernel<WithBlockers<ClassicRules>>;
+
+    // row read from column 0: 1 F 1 1, the blocker holds and the tiles behind it merge
+    EXPECT_EQ(Kernel::Move(0x11f1, Direction::LEFT).board, 0x02f1);
+    EXPECT_EQ(Kernel::Move(0x11f1, Direction::RIGHT).board, 0x20f1);
+    // 0 F 0 1: the 1 slides up to the blocker and never past it
+    EXPECT_EQ(Kernel::Move(0x10f0, Direction::LEFT).board, 0x01f0);
+    // no merge across the blocker
+    EXPECT_EQ(Kernel::Move(0x00f1, Direction::RIGHT).board, 0x00f1);
+
+    // and the same on columns
+    const Board column = SetCell(SetCell(0, 0, 1), 4, 0xf);
+    EXPECT_EQ(Kernel::Move(column, Direction::DOWN).board, column);
+    EXPECT_FALSE(Kernel::HasWon(column));
+}
+
+TEST(TestRules, SpawnsFollowThePolicy)
+{
+    CompactRng gen(5);
+    int counts[4] = {};
+
+    for (int i = 0; i < 30000; ++i)
+    {
+        const auto board = RuleKernel<ThreesRules>::Spawn(0, gen);
+        ASSERT_EQ(CountEmpty(board), BOARD_CELLS - 1);
+        ++counts[MaxExponent(board)];
+    }
+
+    EXPECT_EQ(counts[0], 0);
+
+    for (int code = 1; code <= 3; ++code)
+    {
+        EXPECT_NEAR(counts[code], 10000, 500);
+    }
+}
+
+TEST(TestRules, VariantGamesPlayToTheEnd)
+{
+    BasicCompactGame<FibonacciRules> fibonacci(9);
+    BasicCompactGame<ThreesRules> threes(9);
+    BasicCompactGame<WithBlockers<ClassicRules, 2>> blocked(9);
+    fibonacci.Start();
+    threes.Start();
+    blocked.Start();
+
+    int blockers = 0;
+
+    for (size_t cell = 0; cell < BOARD_CELLS; ++cell)
+    {
+        blockers += GetCell(blocked.GetBoard(), cell) == 0xf ? 1 : 0;
+    }
+
+    EXPECT_EQ(blockers, 2);
+    EXPECT_EQ(CountEmpty(blocked.GetBoard()), BOARD_CELLS - 4);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto dir = static_cast<Direction>(i % 4);
+        fibonacci.Move(dir);
+        threes.Move(dir);
+        blocked.Move(dir);
+    }
+
+    EXPECT_NE(fibonacci.State(), GameState::Playing);
+    EXPECT_NE(threes.State(), GameState::Playing);
+    EXPECT_NE(blocked.State(), GameState::Playing);
+    EXPECT_GT(fibonacci.Score(), 0);
+    EXPECT_GT(threes.Score(), 0);
+}
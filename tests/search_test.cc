@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "../src/search.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+const Board BOARD = 0x0000'0121'0312'2431;
+
+// every allocation of the test binary goes through here, so that a test can count those of a search
+static std::atomic<size_t> allocations = 0;
+
+auto operator new(const size_t size) -> void *
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+TEST(TestSearch, DeepeningReachesTheFixedDepthResult)
+{
+    SearchOptions options;
+    options.depth = 3;
+    const auto fixed = Expectimax(options).BestMove(BOARD);
+    EXPECT_EQ(fixed.depth, 3);
+
+    options.time_budget = std::chrono::seconds(60);
+    const auto deepened = Expectimax(options).BestMove(BOARD);
+
+    EXPECT_EQ(deepened.depth, 3);
+    EXPECT_FALSE(deepened.aborted);
+    EXPECT_FLOAT_EQ(deepened.value, fixed.value);
+    // the shallower iterations come on top
+    EXPECT_GT(deepened.nodes, fixed.nodes);
+}
+
+TEST(TestSearch, DeadlineBoundsTheLatency)
+{
+    TranspositionTable table(4);
+    SearchOptions options;
+    options.depth = 8;
+    options.table = &table;
+    options.time_budget = std::chrono::milliseconds(20);
+
+    const auto start = SearchClock::now();
+    const auto result = Expectimax(options).BestMove(BOARD);
+    const auto elapsed = SearchClock::now() - start;
+
+    // the deadline is polled every few thousand nodes, which leaves a little slack
+    EXPECT_LT(elapsed, std::chrono::milliseconds(40));
+    EXPECT_TRUE(result.move.has_value());
+    EXPECT_FALSE(result.aborted);
+    EXPECT_GE(result.depth, 1);
+    EXPECT_LT(result.depth, 8);
+}
+
+TEST(TestSearch, ExpiredDeadlineStillAnswers)
+{
+    SearchOptions options;
+    options.depth = 8;
+    options.time_budget = std::chrono::microseconds(1);
+
+    const auto result = Expectimax(options).BestMove(BOARD);
+
+    ASSERT_TRUE(result.move.has_value());
+    EXPECT_NE(MoveBoard(BOARD, *result.move).board, BOARD);
+    EXPECT_LT(result.depth, 8);
+}
+
+TEST(TestSearch, CancellingIsNotATimeout)
+{
+    SearchOptions options;
+    options.depth = 8;
+    options.time_budget = std::chrono::seconds(60);
+    options.should_stop = [] { return true; };
+
+    EXPECT_TRUE(Expectimax(options).BestMove(BOARD).aborted);
+}
+
+TEST(TestSearch, TableMovesDoNotChangeValues)
+{
+    SearchOptions options;
+    options.depth = 3;
+    options.time_budget = std::chrono::seconds(60);
+    const auto plain = Expectimax(options).BestMove(BOARD);
+
+    TranspositionTable table(4);
+    options.table = &table;
+    const auto ordered = Expectimax(options).BestMove(BOARD);
+
+    EXPECT_FLOAT_EQ(ordered.value, plain.value);
+    EXPECT_EQ(ordered.depth, 3);
+}
+
+TEST(TestSearch, CrowdedBoardsGetMoreTime)
+{
+    const std::chrono::microseconds limit(1000);
+    const Board open = 0x0000'0000'0000'0011;
+    const Board crowded = 0x1234'5678'9ab1'2345;
+
+    EXPECT_LT(TimeBudget(open, limit), limit / 2);
+    EXPECT_GT(TimeBudget(crowded, limit), TimeBudget(BOARD, limit));
+    EXPECT_EQ(TimeBudget(crowded, limit), limit);
+    EXPECT_LE(TimeBudget(0xffff'ffff'ffff'ffff, limit), limit);
+}
+
+TEST(TestSearch, SearchesAfterTheFirstDoNotAllocate)
+{
+    TranspositionTable table(1);
+    SearchOptions options;
+    options.depth = 3;
+    options.threads = 4;
+    options.table = &table;
+    options.time_budget = std::chrono::milliseconds(5);
+    Expectimax search(options);
+
+    // starts the threads of the root search and builds the evaluator's tables
+    (void)search.BestMove(0x0000'0000'0121'0312);
+
+    const auto before = allocations.load();
+    const auto first = search.BestMove(0x0000'0012'0121'0312);
+    const auto second = search.BestMove(0x0001'0012'2121'0312);
+    const auto after = allocations.load();
+
+    EXPECT_TRUE(first.move.has_value());
+    EXPECT_TRUE(second.move.has_value());
+    EXPECT_EQ(after, before);
+}
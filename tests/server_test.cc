@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include "../src/server.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <netinet/in.h>
+#include <set>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Stands in for a bot: a blocking connection that sends request frames and reads back reply frames.
+class TestClient
+{
+  private:
+    int fd = -1;
+
+  public:
+    explicit TestClient(const std::filesystem::path &path)
+    {
+        sockaddr_un address = {.sun_family = AF_UNIX, .sun_path = {}};
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        EXPECT_EQ(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+    }
+
+    explicit TestClient(const std::uint16_t port)
+    {
+        sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(port), .sin_addr = {}, .sin_zero = {}};
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        EXPECT_EQ(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+    }
+
+    ~TestClient()
+    {
+        close(fd);
+    }
+
+    TestClient(const TestClient &) = delete;
+    auto operator=(const TestClient &) -> TestClient & = delete;
+
+    void Send(const std::vector<ServerRequest> &requests) const
+    {
+        const auto bytes = requests.size() * sizeof(ServerRequest);
+        ASSERT_EQ(send(fd, requests.data(), bytes, 0), static_cast<ssize_t>(bytes));
+    }
+
+    auto Receive(const size_t count) const -> std::vector<ServerReply>
+    {
+        std::vector<ServerReply> replies(count);
+        auto *data = reinterpret_cast<char *>(replies.data());
+        size_t received = 0;
+
+        while (received < count * sizeof(ServerReply))
+        {
+            const auto n = recv(fd, data + received, count * sizeof(ServerReply) - received, 0);
+
+            if (n <= 0)
+            {
+                ADD_FAILURE() << "connection closed";
+                break;
+            }
+
+            received += static_cast<size_t>(n);
+        }
+
+        return replies;
+    }
+
+    auto Call(const ServerRequest &request) const -> ServerReply
+    {
+        Send({request});
+        return Receive(1)[0];
+    }
+};
+
+static auto SocketPath(const std::string &name) -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path() / (name + "_" + std::to_string(getpid()) + ".sock");
+}
+
+TEST(TestServer, NewGameMoveAndClose)
+{
+    const auto path = SocketPath("c2048_server");
+    Server server({.socket_path = path, .port = 0, .reactors = 2});
+    TestClient client(path);
+
+    const auto created = client.Call({.session = 42, .command = ServerCommand::NewGame});
+    EXPECT_EQ(created.status, ServerStatus::Ok);
+    EXPECT_EQ(created.state, GameState::Playing);
+    EXPECT_NE(created.session, 0);
+
+    // same seed, same game as a local CompactGame
+    CompactGame reference(42);
+    reference.Start();
+    EXPECT_EQ(created.board, reference.GetBoard());
+
+    for (int i = 0; i < 20; ++i)
+    {
+        const auto dir = static_cast<Direction>(i % 4);
+        const bool legal = reference.Move(dir);
+        const auto reply =
+            client.Call({.session = created.session, .command = ServerCommand::Move, .direction = dir});
+
+        EXPECT_EQ(reply.status, legal ? ServerStatus::Ok : ServerStatus::Illegal);
+        EXPECT_EQ(reply.board, reference.GetBoard());
+        EXPECT_EQ(reply.score, reference.Score());
+    }
+
+    EXPECT_EQ(server.Sessions(), 1);
+    EXPECT_EQ(client.Call({.session = created.session, .command = ServerCommand::Close}).status, ServerStatus::Ok);
+    EXPECT_EQ(client.Call({.session = created.session, .command = ServerCommand::State}).status,
+              ServerStatus::UnknownSession);
+    EXPECT_EQ(server.Sessions(), 0);
+}
+
+TEST(TestServer, PipelinedRequestsAreAnsweredInOrder)
+{
+    const auto path = SocketPath("c2048_pipeline");
+    Server server({.socket_path = path, .port = 0, .reactors = 1});
+    TestClient client(path);
+
+    const auto session = client.Call({.session = 1, .command = ServerCommand::NewGame}).session;
+
+    std::vector<ServerRequest> batch;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        batch.push_back({.session = session, .command = ServerCommand::State});
+    }
+
+    client.Send(batch);
+    const auto replies = client.Receive(batch.size());
+
+    for (const auto &reply : replies)
+    {
+        EXPECT_EQ(reply.session, session);
+        EXPECT_EQ(reply.status, ServerStatus::Ok);
+    }
+}
+
+TEST(TestServer, SessionsAreIsolatedBetweenConnections)
+{
+    const auto path = SocketPath("c2048_isolation");
+    Server server({.socket_path = path, .port = 0, .reactors = 1});
+    TestClient owner(path);
+    TestClient intruder(path);
+
+    const auto session = owner.Call({.session = 1, .command = ServerCommand::NewGame}).session;
+    EXPECT_EQ(intruder.Call({.session = session, .command = ServerCommand::State}).status,
+              ServerStatus::UnknownSession);
+    EXPECT_EQ(owner.Call({.session = session, .command = static_cast<ServerCommand>(99)}).status,
+              ServerStatus::BadRequest);
+}
+
+TEST(TestServer, ExistingFileIsLeftAlone)
+{
+    const auto path = SocketPath("c2048_not_a_socket");
+    std::ofstream(path) << "keep me";
+
+    EXPECT_THROW(Server({.socket_path = path, .port = 0, .reactors = 1}), std::runtime_error);
+
+    std::string contents;
+    std::getline(std::ifstream(path), contents);
+    EXPECT_EQ(contents, "keep me");
+    std::filesystem::remove(path);
+}
+
+TEST(TestServer, LiveServerIsNotTakenOver)
+{
+    const auto path = SocketPath("c2048_live");
+    Server server({.socket_path = path, .port = 0, .reactors = 1});
+
+    EXPECT_THROW(Server({.socket_path = path, .port = 0, .reactors = 1}), std::runtime_error);
+
+    // the first server still owns the path
+    TestClient client(path);
+    EXPECT_EQ(client.Call({.session = 1, .command = ServerCommand::NewGame}).status, ServerStatus::Ok);
+}
+
+TEST(TestServer, StaleSocketIsReplaced)
+{
+    const auto path = SocketPath("c2048_stale");
+    sockaddr_un address = {.sun_family = AF_UNIX, .sun_path = {}};
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // a server that went away without removing its socket
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_EQ(bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+    close(fd);
+
+    Server server({.socket_path = path, .port = 0, .reactors = 1});
+    TestClient client(path);
+    EXPECT_EQ(client.Call({.session = 1, .command = ServerCommand::NewGame}).status, ServerStatus::Ok);
+}
+
+TEST(TestServer, SessionIdsWrapAroundPastLiveGames)
+{
+    constexpr std::uint32_t shards = 3;
+    constexpr std::uint32_t shard = 2;
+    constexpr std::uint32_t last_slot = (std::numeric_limits<std::uint32_t>::max() - shard) / shards;
+    // the games of the first slots are still in play when the ids come back to them
+    const std::set<std::uint32_t> live = {1 * shards + shard, 2 * shards + shard, 4 * shards + shard};
+    SessionIds ids(shard, shards, last_slot - 1);
+    const auto is_live = [&](const std::uint32_t id) { return live.contains(id); };
+
+    EXPECT_EQ(ids.Next(is_live), (last_slot - 1) * shards + shard);
+    EXPECT_EQ(ids.Next(is_live), last_slot * shards + shard);
+    EXPECT_EQ(ids.Next(is_live), 3 * shards + shard);
+    EXPECT_EQ(ids.Next(is_live), 5 * shards + shard);
+}
+
+TEST(TestServer, ManyClientsOnLoopbackTcp)
+{
+    constexpr unsigned reactors = 4;
+    Server server({.socket_path = {}, .port = 0, .reactors = reactors});
+    ASSERT_NE(server.Port(), 0);
+
+    std::vector<std::unique_ptr<TestClient>> clients;
+    std::set<std::uint32_t> sessions;
+
+    for (std::uint32_t seed = 0; seed < 64; ++seed)
+    {
+        const auto &client = clients.emplace_back(std::make_unique<TestClient>(server.Port()));
+        const auto reply = client->Call({.session = seed, .command = ServerCommand::NewGame});
+        EXPECT_EQ(reply.status, ServerStatus::Ok);
+        sessions.insert(reply.session);
+    }
+
+    EXPECT_EQ(sessions.size(), 64);
+    EXPECT_EQ(server.Sessions(), 64);
+
+    // games end with their connection
+    clients.clear();
+
+    for (int attempt = 0; attempt < 1000 && server.Sessions() != 0; ++attempt)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(server.Sessions(), 0);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "../src/shared_state.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static auto TestObjectName(const std::string &name) -> std::string
+{
+    return "/c2048_" + name + "_" + std::to_string(getpid());
+}
+
+// every field holds `value`, so that a torn read shows as a mix
+static auto UniformSnapshot(const std::uint32_t value) -> GameSnapshot
+{
+    GameSnapshot snapshot;
+    snapshot.tiles.fill(value);
+    snapshot.score = value;
+    snapshot.best_score = value;
+    snapshot.moves = value;
+    snapshot.state = GameState::Playing;
+    return snapshot;
+}
+
+TEST(TestSharedState, SnapshotOfAGame)
+{
+    Game game(3);
+    game.Start();
+    game.Move(Direction::LEFT);
+    game.Update();
+    game.Move(Direction::UP);
+    game.Update();
+
+    const auto snapshot = TakeSnapshot(game);
+    const auto &grid = game.GetGrid();
+
+    EXPECT_EQ(snapshot.moves, 2);
+    EXPECT_EQ(snapshot.score, game.Score());
+    EXPECT_EQ(snapshot.state, GameState::Playing);
+    EXPECT_EQ(snapshot.tiles[grid.Cols() + 2], static_cast<std::uint32_t>(grid.GetTile(1, 2).value));
+    EXPECT_GE(std::accumulate(snapshot.tiles.begin(), snapshot.tiles.end(), 0U), 6U);
+
+    game.Reset();
+    EXPECT_EQ(TakeSnapshot(game).moves, 0);
+}
+
+TEST(TestSharedState, ViewerSeesWhatIsPublished)
+{
+    const auto name = TestObjectName("published");
+    StatePublisher publisher(name);
+    const StateViewer viewer(name);
+
+    EXPECT_EQ(viewer.Sequence(), 0);
+
+    auto snapshot = UniformSnapshot(0);
+    snapshot.tiles = {0, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 131072};
+    snapshot.score = 1234567;
+    snapshot.best_score = 7654321;
+    snapshot.moves = 42;
+    snapshot.state = GameState::Victory;
+    publisher.Publish(snapshot);
+
+    EXPECT_EQ(viewer.Sequence(), 2);
+    EXPECT_EQ(viewer.Read(), snapshot);
+}
+
+TEST(TestSharedState, ViewerNeedsAPublisher)
+{
+    EXPECT_THROW(StateViewer(TestObjectName("missing")), std::runtime_error);
+
+    const auto name = TestObjectName("gone");
+    {
+        const StatePublisher publisher(name);
+    }
+
+    EXPECT_THROW(StateViewer{name}, std::runtime_error);
+}
+
+TEST(TestSharedState, OneWriterPerName)
+{
+    const auto name = TestObjectName("writers");
+    StatePublisher publisher(name);
+    publisher.Publish(UniformSnapshot(5));
+
+    EXPECT_THROW(StatePublisher{name}, std::runtime_error);
+
+    // the live writer keeps its object and its sequence
+    const StateViewer viewer(name);
+    EXPECT_EQ(viewer.Sequence(), 2);
+    EXPECT_EQ(viewer.Read(), UniformSnapshot(5));
+}
+
+TEST(TestSharedState, LeftoverObjectIsTakenOver)
+{
+    // what a run that crashed before writing its header leaves
+    const auto name = TestObjectName("leftover");
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, sizeof(SharedStateSegment)), 0);
+    close(fd);
+
+    StatePublisher publisher(name);
+    publisher.Publish(UniformSnapshot(9));
+    EXPECT_EQ(StateViewer(name).Read(), UniformSnapshot(9));
+}
+
+TEST(TestSharedState, ReadsAreNeverTorn)
+{
+    const auto name = TestObjectName("torn");
+    StatePublisher publisher(name);
+    const StateViewer viewer(name);
+    std::atomic<bool> done = false;
+
+    std::jthread writer([&] {
+        for (std::uint32_t value = 1; value <= 200000; ++value)
+        {
+            publisher.Publish(UniformSnapshot(value));
+        }
+
+        done = true;
+    });
+
+    std::uint64_t reads = 0;
+    std::uint32_t last = 0;
+
+    while (!done)
+    {
+        const auto snapshot = viewer.Read();
+
+        if (!snapshot)
+        {
+            continue;
+        }
+
+        // nothing published yet reads as zeros
+        const auto value = static_cast<std::uint32_t>(snapshot->moves);
+        ASSERT_EQ(*snapshot, value == 0 ? GameSnapshot{} : UniformSnapshot(value));
+        // publications are seen in order
+        ASSERT_GE(value, last);
+        last = value;
+        ++reads;
+    }
+
+    EXPECT_GT(reads, 0);
+}
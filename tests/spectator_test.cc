@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "../src/spectator.h"
+
+#include <chrono>
+#include <thread>
+
+// polls like the render loop does, giving up after a few seconds
+static auto WaitForMoves(const SpectatorPool &pool, const std::uint64_t moves) -> bool
+{
+    for (int attempt = 0; attempt < 5000 && pool.Moves() < moves; ++attempt)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return pool.Moves() >= moves;
+}
+
+TEST(TestSpectatorPool, GamesStartWithTwoTiles)
+{
+    // paced slowly enough that no game moves before the check
+    SpectatorPool pool(6, 2, 0.001, 1);
+    ASSERT_EQ(pool.Size(), 6);
+
+    for (int attempt = 0; attempt < 5000 && pool.Get(5).state == GameState::Startup; ++attempt)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (size_t game = 0; game < pool.Size(); ++game)
+    {
+        const auto board = pool.Get(game);
+        EXPECT_EQ(board.state, GameState::Playing);
+        EXPECT_LE(CountEmpty(board.board), 14);
+    }
+}
+
+TEST(TestSpectatorPool, GamesAdvanceAndStartOver)
+{
+    SearchOptions options;
+    options.depth = 1;
+    SpectatorPool pool(4, 2, 0, 7, options);
+
+    ASSERT_TRUE(WaitForMoves(pool, 200));
+
+    for (size_t game = 0; game < pool.Size(); ++game)
+    {
+        EXPECT_GT(TileSum(pool.Get(game).board), 0);
+    }
+
+    // the games are played to the end, then replaced
+    for (int attempt = 0; attempt < 20000 && pool.FinishedGames() == 0; ++attempt)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_GT(pool.FinishedGames(), 0);
+}
+
+TEST(TestSpectatorPool, PaceLimitsTheMoves)
+{
+    SearchOptions options;
+    options.depth = 1;
+    SpectatorPool pool(2, 1, 20, 3, options);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+    // 20 moves per second and per game: about 10 moves in total so far
+    EXPECT_LE(pool.Moves(), 16);
+}
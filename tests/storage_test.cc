@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include "../src/storage.h"
+
+#include <fstream>
+
+class StorageTest : public ::testing::Test
+{
+  public:
+    std::filesystem::path dir;
+    std::filesystem::path path;
+
+    void SetUp() override
+    {
+        dir = std::filesystem::temp_directory_path() / "c2048_storage_test";
+        path = dir / "session.txt";
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+};
+
+TEST_F(StorageTest, LoadMissingFile)
+{
+    const Storage storage(path);
+    EXPECT_FALSE(storage.Load().has_value());
+}
+
+TEST_F(StorageTest, SaveAndLoad)
+{
+    SessionState session;
+    session.best_score = 4096;
+    session.score = 1024;
+    session.seed = 42;
+    session.state = GameState::Playing;
+    session.tiles.at(0) = 2;
+    session.tiles.at(15) = 512;
+
+    {
+        // the destructor waits for the pending save
+        Storage storage(path);
+        storage.SaveAsync(session);
+    }
+
+    const auto loaded = Storage(path).Load();
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->best_score, 4096);
+    EXPECT_EQ(loaded->score, 1024);
+    EXPECT_EQ(loaded->seed, 42);
+    EXPECT_EQ(loaded->state, GameState::Playing);
+    EXPECT_EQ(loaded->tiles, session.tiles);
+    EXPECT_FALSE(std::filesystem::exists(dir / "session.txt.tmp"));
+}
+
+TEST_F(StorageTest, LatestSaveWins)
+{
+    {
+        Storage storage(path);
+
+        for (std::uint32_t score = 0; score <= 100; ++score)
+        {
+            SessionState session;
+            session.score = score;
+            storage.SaveAsync(session);
+        }
+    }
+
+    const auto loaded = Storage(path).Load();
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->score, 100);
+}
+
+TEST_F(StorageTest, LoadCorruptedFile)
+{
+    std::filesystem::create_directories(dir);
+    std::ofstream(path) << "C2048 1\nbest 10\nscore";
+
+    const Storage storage(path);
+    EXPECT_FALSE(storage.Load().has_value());
+}
+
+TEST_F(StorageTest, CaptureAndRestoreGame)
+{
+    Game game(7);
+    game.Start();
+    game.GetGrid().SetTile(1, 2, 64);
+
+    const SessionState session = CaptureSession(game);
+
+    Game restored;
+    RestoreSession(restored, session);
+
+    EXPECT_EQ(restored.State(), GameState::Playing);
+    EXPECT_EQ(restored.Seed(), 7);
+    EXPECT_EQ(restored.GetGrid().GetTile(1, 2).value, 64);
+    EXPECT_EQ(restored.GetGrid().GetTile(1, 2).row, 1);
+    EXPECT_EQ(restored.GetGrid().GetTile(1, 2).col, 2);
+}
+
+TEST_F(StorageTest, RestoredGameSpawnsAsIfUninterrupted)
+{
+    Game game(11);
+    game.Start();
+
+    for (const auto dir : {Direction::LEFT, Direction::UP, Direction::RIGHT, Direction::DOWN})
+    {
+        game.Move(dir);
+        game.Update();
+    }
+
+    {
+        Storage storage(path);
+        storage.SaveAsync(CaptureSession(game));
+    }
+
+    const auto loaded = Storage(path).Load();
+    ASSERT_TRUE(loaded.has_value());
+
+    Game restored;
+    RestoreSession(restored, *loaded);
+
+    for (const auto dir : {Direction::LEFT, Direction::UP, Direction::LEFT, Direction::UP})
+    {
+        game.Move(dir);
+        game.Update();
+        restored.Move(dir);
+        restored.Update();
+        EXPECT_EQ(CaptureSession(restored).tiles, CaptureSession(game).tiles);
+    }
+}
+
+TEST_F(StorageTest, EndlessSession)
+{
+    Game game(3);
+    game.Start();
+    game.GetGrid().SetTile(0, 0, 131072);
+    game.Restore(game.GetGrid(), 5'000'000'000, 5'000'000'000, GameState::Playing, 3, true);
+
+    {
+        Storage storage(path);
+        storage.SaveAsync(CaptureSession(game));
+    }
+
+    const auto loaded = Storage(path).Load();
+    ASSERT_TRUE(loaded.has_value());
+
+    Game restored;
+    RestoreSession(restored, *loaded);
+    EXPECT_TRUE(restored.Endless());
+    EXPECT_EQ(restored.Score(), 5'000'000'000);
+    EXPECT_EQ(restored.GetGrid().GetTile(0, 0).value, 131072);
+}
+
+TEST_F(StorageTest, LoadPreviousVersion)
+{
+    std::filesystem::create_directories(dir);
+    std::ofstream(path) << "C2048 1\nbest 10\nscore 8\nstate 2\nseed 5\ntiles 2 4 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+
+    const Storage storage(path);
+    const auto loaded = storage.Load();
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_FALSE(loaded->endless);
+    EXPECT_EQ(loaded->tiles[1], 4);
+}
+
+TEST_F(StorageTest, LoadInvalidTile)
+{
+    std::filesystem::create_directories(dir);
+    std::ofstream(path) << "C2048 2\nbest 10\nscore 8\nstate 2\nseed 5\nendless 0\n"
+                           "tiles 3 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+
+    const Storage storage(path);
+    EXPECT_FALSE(storage.Load().has_value());
+}
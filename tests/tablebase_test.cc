@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "../src/search.h"
+#include "../src/tablebase.h"
+
+#include <fstream>
+#include <iterator>
+
+// Row 0 is free, the other rows hold large tiles that never merge with each other.
+constexpr Board FIXED_ROWS = 0xfedc'edcb'dcba'0000;
+
+class TablebaseTest : public ::testing::Test
+{
+  public:
+    TablebaseSpec spec;
+    std::filesystem::path path;
+
+    void SetUp() override
+    {
+        spec.fixed = FIXED_ROWS;
+        spec.free_mask = 0x000f;
+        spec.max_exponent = 3;
+
+        path = std::filesystem::temp_directory_path() / "c2048_tablebase_test.tb";
+        GenerateTablebase(spec, path, 1);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+};
+
+TEST_F(TablebaseTest, InvalidSpec)
+{
+    TablebaseSpec invalid = spec;
+    invalid.max_exponent = 1;
+    ASSERT_THROW(invalid.Validate(), std::invalid_argument);
+
+    invalid = spec;
+    invalid.fixed = 0;
+    ASSERT_THROW(invalid.Validate(), std::invalid_argument);
+}
+
+TEST_F(TablebaseTest, IndexRoundTrip)
+{
+    const TablebaseIndex index(spec);
+    ASSERT_EQ(index.Size(), 256);
+
+    for (std::uint64_t i = 0; i < index.Size(); ++i)
+    {
+        ASSERT_EQ(index.Index(index.PositionAt(i)), i);
+    }
+}
+
+TEST_F(TablebaseTest, ProbeKnownPositions)
+{
+    const Tablebase tablebase(path);
+
+    // 8 8 _ _ merges into the target right away
+    EXPECT_FLOAT_EQ(*tablebase.Probe(FIXED_ROWS | 0x0033), 1.0f);
+
+    // 2 4 2 4 has no legal move
+    EXPECT_FLOAT_EQ(*tablebase.Probe(FIXED_ROWS | 0x2121), 0.0f);
+
+    // 2 _ _ _ can only slide sideways, the spawns decide
+    const float single = *tablebase.Probe(FIXED_ROWS | 0x0001);
+    EXPECT_GT(single, 0.0f);
+    EXPECT_LT(single, 1.0f);
+}
+
+TEST_F(TablebaseTest, ProbeSymmetricLayouts)
+{
+    const Tablebase tablebase(path);
+    const Board board = FIXED_ROWS | 0x0201;
+    const float value = *tablebase.Probe(board);
+
+    for (const Board symmetric : Symmetries(board))
+    {
+        EXPECT_FLOAT_EQ(*tablebase.Probe(symmetric), value);
+    }
+}
+
+TEST_F(TablebaseTest, ProbeOutsideSubproblem)
+{
+    const Tablebase tablebase(path);
+    EXPECT_FALSE(tablebase.Probe(0x0033).has_value());
+    EXPECT_FALSE(tablebase.Probe(FIXED_ROWS | 0x0005).has_value());
+}
+
+TEST_F(TablebaseTest, ParallelGenerationIsDeterministic)
+{
+    const auto parallel_path = std::filesystem::temp_directory_path() / "c2048_tablebase_test_parallel.tb";
+    GenerateTablebase(spec, parallel_path, 4);
+
+    std::ifstream serial(path, std::ios::binary);
+    std::ifstream parallel(parallel_path, std::ios::binary);
+
+    const std::string serial_bytes(std::istreambuf_iterator<char>(serial), {});
+    const std::string parallel_bytes(std::istreambuf_iterator<char>(parallel), {});
+    EXPECT_EQ(serial_bytes, parallel_bytes);
+
+    std::filesystem::remove(parallel_path);
+}
+
+TEST_F(TablebaseTest, SearchUsesTablebase)
+{
+    const Tablebase tablebase(path);
+
+    SearchOptions options;
+    options.depth = 1;
+    options.tablebase = &tablebase;
+
+    Expectimax search(options);
+    const auto result = search.BestMove(FIXED_ROWS | 0x0330);
+
+    ASSERT_TRUE(result.move.has_value());
+    EXPECT_TRUE(*result.move == Direction::LEFT || *result.move == Direction::RIGHT);
+}
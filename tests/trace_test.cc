@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "../src/trace.h"
+
+#include <algorithm>
+#include <string_view>
+#include <thread>
+
+TEST(TestTrace, BufferKeepsTheNewestEvents)
+{
+    TraceBuffer buffer(7, 4);
+    EXPECT_TRUE(buffer.Snapshot().empty());
+
+    const char *names[] = {"a", "b", "c", "d", "e", "f"};
+
+    for (std::uint64_t i = 0; i < 6; ++i)
+    {
+        buffer.Record(names[i], i * 10, i * 10 + 5);
+    }
+
+    const auto events = buffer.Snapshot();
+    ASSERT_EQ(events.size(), 3);
+
+    // the oldest slot is dropped, the writer might have been overwriting it
+    EXPECT_STREQ(events[0].name, "d");
+    EXPECT_STREQ(events[2].name, "f");
+    EXPECT_EQ(events[2].begin_ns, 50);
+    EXPECT_EQ(events[2].end_ns, 55);
+    EXPECT_EQ(events[2].thread, 7);
+}
+
+TEST(TestTrace, ScopesOfEveryThreadAreCollected)
+{
+    {
+        const TraceScope outer("test::outer");
+        const TraceScope inner("test::inner");
+    }
+
+    std::jthread([] { const TraceScope worker("test::worker"); }).join();
+
+    const auto events = CollectTraceEvents();
+    const auto find = [&events](const std::string_view name) -> const TraceEvent * {
+        const auto found =
+            std::ranges::find(events, name, [](const TraceEvent &event) { return std::string_view(event.name); });
+        return found == events.end() ? nullptr : &*found;
+    };
+
+    const auto *outer = find("test::outer");
+    const auto *inner = find("test::inner");
+    const auto *worker = find("test::worker");
+
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    ASSERT_NE(worker, nullptr);
+
+    EXPECT_LE(outer->begin_ns, inner->begin_ns);
+    EXPECT_GE(outer->end_ns, inner->end_ns);
+    EXPECT_NE(worker->thread, outer->thread);
+}
+
+TEST(TestTrace, ChromeFormat)
+{
+    const auto json = FormatChromeTrace({{"Game::Move", 1500, 4000, 2}});
+    EXPECT_NE(json.find(R"("name":"Game::Move","ph":"X","ts":1.500,"dur":2.500,"pid":1,"tid":2)"), std::string::npos);
+    EXPECT_TRUE(json.starts_with("{\"traceEvents\":["));
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include "../src/search.h"
+#include "../src/transposition_table.h"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+TEST(TestTranspositionTable, StoreAndProbe)
+{
+    TranspositionTable table(1);
+    EXPECT_GT(table.Capacity(), 0);
+    EXPECT_FALSE(table.Probe(0x1234).has_value());
+
+    table.Store(0x1234, 3, 42.5f, Direction::LEFT);
+
+    const auto entry = table.Probe(0x1234);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->depth, 3);
+    EXPECT_FLOAT_EQ(entry->value, 42.5f);
+    EXPECT_EQ(entry->move, Direction::LEFT);
+
+    table.Clear();
+    EXPECT_FALSE(table.Probe(0x1234).has_value());
+}
+
+TEST(TestTranspositionTable, StoreWithoutMove)
+{
+    TranspositionTable table(1);
+    table.Store(0x42, 0, -1.0f, std::nullopt);
+
+    const auto entry = table.Probe(0x42);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_FALSE(entry->move.has_value());
+    EXPECT_FLOAT_EQ(entry->value, -1.0f);
+}
+
+TEST(TestTranspositionTable, DeeperResultsArePreferred)
+{
+    TranspositionTable table(1);
+    table.Store(0x1234, 4, 1.0f, Direction::UP);
+    table.Store(0x1234, 2, 2.0f, Direction::DOWN);
+    EXPECT_EQ(table.Probe(0x1234)->depth, 4);
+
+    // results of an older search can be replaced by shallower ones
+    table.NewSearch();
+    table.Store(0x1234, 2, 2.0f, Direction::DOWN);
+    EXPECT_EQ(table.Probe(0x1234)->depth, 2);
+}
+
+TEST(TestTranspositionTable, ConcurrentAccessNeverReturnsWrongEntries)
+{
+    // a small table, so that threads keep overwriting each other's buckets
+    TranspositionTable table(1);
+    std::vector<std::jthread> threads;
+    std::atomic<int> mismatches = 0;
+
+    for (int id = 0; id < 4; ++id)
+    {
+        threads.emplace_back([&table, &mismatches, id] {
+            for (Board board = 1; board < 200000; ++board)
+            {
+                const Board key = board * 4 + id;
+                table.Store(key, static_cast<int>(key % 16), static_cast<float>(key), std::nullopt);
+
+                if (const auto entry = table.Probe(key * 7 + 1); entry && entry->value != static_cast<float>(key * 7 + 1))
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+
+    threads.clear();
+    EXPECT_EQ(mismatches, 0);
+}
+
+TEST(TestTranspositionTable, SearchResultsMatch)
+{
+    const Board board = 0x0000'0121'0312'2431;
+
+    SearchOptions options;
+    options.depth = 2;
+    const auto expected = Expectimax(options).BestMove(board);
+
+    TranspositionTable table(4);
+    options.table = &table;
+    Expectimax search(options);
+
+    const auto first = search.BestMove(board);
+    EXPECT_EQ(first.move, expected.move);
+    EXPECT_FLOAT_EQ(first.value, expected.value);
+    EXPECT_LE(first.nodes, expected.nodes);
+
+    // the second search reads the children of the root back from the table
+    const auto second = search.BestMove(board);
+    EXPECT_EQ(second.move, expected.move);
+    EXPECT_LT(second.nodes, first.nodes);
+}
+
+TEST(TestTranspositionTable, FileTablesPersistAndShare)
+{
+    const auto path = std::filesystem::temp_directory_path() / "c2048_transposition_table_test.tt";
+    std::filesystem::remove(path);
+
+    {
+        TranspositionTable first(path, 1, SEARCH_VALUES_VERSION);
+        TranspositionTable second(path, 1, SEARCH_VALUES_VERSION);
+
+        // two mappings of the file, as two processes would have
+        first.Store(0x1234, 3, 42.5f, Direction::LEFT);
+        ASSERT_TRUE(second.Probe(0x1234).has_value());
+        EXPECT_EQ(second.Probe(0x1234)->move, Direction::LEFT);
+    }
+
+    // an existing file keeps its size and its entries
+    TranspositionTable reopened(path, 16, SEARCH_VALUES_VERSION);
+    EXPECT_EQ(reopened.Capacity(), TranspositionTable(1).Capacity());
+    ASSERT_TRUE(reopened.Probe(0x1234).has_value());
+    EXPECT_FLOAT_EQ(reopened.Probe(0x1234)->value, 42.5f);
+
+    std::filesystem::remove(path);
+}
+
+TEST(TestTranspositionTable, FileTablesAgePerProcess)
+{
+    const auto path = std::filesystem::temp_directory_path() / "c2048_transposition_table_age_test.tt";
+    std::filesystem::remove(path);
+
+    {
+        TranspositionTable first(path, 1, SEARCH_VALUES_VERSION);
+        TranspositionTable second(path, 1, SEARCH_VALUES_VERSION);
+
+        // the other process moving on leaves the deep result of this one's search in place
+        first.Store(0x1234, 4, 1.0f, Direction::UP);
+        second.NewSearch();
+        first.Store(0x1234, 2, 2.0f, Direction::DOWN);
+        EXPECT_EQ(second.Probe(0x1234)->depth, 4);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(TestTranspositionTable, FileWithABlankHeaderIsInitialized)
+{
+    const auto path = std::filesystem::temp_directory_path() / "c2048_transposition_table_blank_test.tt";
+
+    // what a crash between sizing the file and writing its header leaves
+    {
+        const std::ofstream create(path, std::ios::trunc);
+    }
+
+    std::filesystem::resize_file(path, 4096);
+
+    {
+        TranspositionTable table(path, 1, SEARCH_VALUES_VERSION);
+        EXPECT_EQ(table.Capacity(), TranspositionTable(1).Capacity());
+        table.Store(0x1234, 3, 42.5f, Direction::LEFT);
+    }
+
+    EXPECT_FLOAT_EQ(TranspositionTable(path, 1, SEARCH_VALUES_VERSION).Probe(0x1234)->value, 42.5f);
+    std::filesystem::remove(path);
+}
+
+TEST(TestTranspositionTable, FileTablesRefuseOtherValues)
+{
+    const auto path = std::filesystem::temp_directory_path() / "c2048_transposition_table_version_test.tt";
+    std::filesystem::remove(path);
+
+    (void)TranspositionTable(path, 1, 7);
+    EXPECT_THROW(TranspositionTable(path, 1, 8), std::runtime_error);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a table";
+    }
+
+    EXPECT_THROW(TranspositionTable(path, 1, 7), std::runtime_error);
+    std::filesystem::remove(path);
+}
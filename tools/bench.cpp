@@ -0,0 +1,222 @@
+#include "../src/board.h"
+#include "../src/game.h"
+#include "../src/heuristic.h"
+#include "../src/perf_counters.h"
+#include "../src/search.h"
+
+#include <chrono>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_bench [--moves <n>] [--searches <n>] [--depth <n>] [--seed <n>] [--perf]\n"
+                 "--perf reads the hardware counters around every benchmark (Linux perf_event_open)\n";
+}
+
+struct BenchOptions
+{
+    std::uint64_t moves = 1000000;
+    std::uint64_t searches = 200;
+    int depth = 2;
+    std::uint32_t seed = 1;
+    bool perf = false;
+};
+
+auto FormatMetric(const std::optional<double> value, const int precision) -> std::string
+{
+    return value ? std::format("{:.{}f}", *value, precision) : "-";
+}
+
+// runs `body`, which returns the number of operations it performed, and prints one line of results
+void Measure(const std::string_view name, const BenchOptions &options, const std::function<std::uint64_t()> &body)
+{
+    std::optional<PerfCounters> counters;
+
+    if (options.perf)
+    {
+        counters.emplace();
+        counters->Start();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto operations = body();
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+    const auto reading = counters ? counters->Stop() : PerfReading();
+    const auto ns = operations == 0 ? 0.0 : elapsed.count() / static_cast<double>(operations);
+
+    std::cout << std::format("{:<16}{:>12}{:>14.1f}", name, operations, ns);
+
+    if (options.perf)
+    {
+        const auto instructions = reading.Get(PerfEvent::Instructions);
+        const auto branch_miss_rate =
+            instructions ? reading.PerOperation(PerfEvent::BranchMisses, *instructions / 1000) : std::nullopt;
+
+        std::cout << std::format("{:>8}{:>14}{:>12}{:>12}{:>12}",
+                                 FormatMetric(reading.Ratio(PerfEvent::Instructions, PerfEvent::Cycles), 2),
+                                 FormatMetric(reading.PerOperation(PerfEvent::Instructions, operations), 1),
+                                 FormatMetric(branch_miss_rate, 2),
+                                 FormatMetric(reading.PerOperation(PerfEvent::L1DataMisses, operations), 2),
+                                 FormatMetric(reading.PerOperation(PerfEvent::LlcMisses, operations), 3));
+    }
+
+    std::cout << '\n';
+}
+
+auto main(int argc, char **argv) -> int
+{
+    BenchOptions options;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view option = argv[i];
+
+            if (option == "--perf")
+            {
+                options.perf = true;
+                continue;
+            }
+
+            if (i + 1 == argc)
+            {
+                PrintUsage();
+                return 1;
+            }
+
+            const std::string value = argv[++i];
+
+            if (option == "--moves")
+            {
+                options.moves = std::stoull(value);
+            }
+            else if (option == "--searches")
+            {
+                options.searches = std::stoull(value);
+            }
+            else if (option == "--depth")
+            {
+                options.depth = std::stoi(value);
+            }
+            else if (option == "--seed")
+            {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    if (options.perf && !PerfCounters().Available())
+    {
+        std::cerr << "hardware counters are not available: no PMU, or restricted by perf_event_paranoid\n";
+    }
+
+    std::cout << std::format("{:<16}{:>12}{:>14}", "benchmark", "operations", "ns/op");
+
+    if (options.perf)
+    {
+        std::cout << std::format("{:>8}{:>14}{:>12}{:>12}{:>12}", "IPC", "instr/op", "brmiss/ki", "L1d/op",
+                                 "LLC/op");
+    }
+
+    std::cout << '\n';
+
+    // random games on the grid, a move and a spawn per operation
+    Measure("Game::Move", options, [&options] {
+        Game game(options.seed);
+        std::mt19937 gen(options.seed);
+        std::uniform_int_distribution<int> direction(0, 3);
+        game.Start();
+
+        for (std::uint64_t move = 0; move < options.moves; ++move)
+        {
+            if (game.State() != GameState::Playing)
+            {
+                game.Reset();
+            }
+
+            game.Move(static_cast<Direction>(direction(gen)));
+            game.Update();
+        }
+
+        return options.moves;
+    });
+
+    // the same on packed boards and the row tables
+    Measure("MoveBoard", options, [&options] {
+        std::mt19937 gen(options.seed);
+        std::uniform_int_distribution<int> direction(0, 3);
+        Board board = SpawnRandom(SpawnRandom(0, gen), gen);
+
+        for (std::uint64_t move = 0; move < options.moves; ++move)
+        {
+            const Board moved = MoveBoard(board, static_cast<Direction>(direction(gen))).board;
+            board = CountEmpty(moved) == 0 ? SpawnRandom(SpawnRandom(0, gen), gen) : SpawnRandom(moved, gen);
+        }
+
+        return options.moves;
+    });
+
+    // leaf evaluation, the innermost loop of the search, over the boards of a random game
+    Measure("Heuristic", options, [&options] {
+        std::mt19937 gen(options.seed);
+        std::uniform_int_distribution<int> direction(0, 3);
+        std::vector<Board> boards(4096);
+        Board board = SpawnRandom(SpawnRandom(0, gen), gen);
+
+        for (auto &sample : boards)
+        {
+            const Board moved = MoveBoard(board, static_cast<Direction>(direction(gen))).board;
+            board = CountEmpty(moved) == 0 ? SpawnRandom(SpawnRandom(0, gen), gen) : SpawnRandom(moved, gen);
+            sample = board;
+        }
+
+        float total = 0;
+
+        for (std::uint64_t i = 0; i < options.moves; ++i)
+        {
+            total += EvaluateHeuristic(boards[i % boards.size()]);
+        }
+
+        // keeps the loop from being optimized away
+        volatile float sink = total;
+        (void)sink;
+        return options.moves;
+    });
+
+    Measure("Expectimax", options, [&options] {
+        SearchOptions search_options;
+        search_options.depth = options.depth;
+        std::mt19937 gen(options.seed);
+        Board board = SpawnRandom(SpawnRandom(0, gen), gen);
+
+        for (std::uint64_t i = 0; i < options.searches; ++i)
+        {
+            const auto result = Expectimax(search_options).BestMove(board);
+            board = result.move ? SpawnRandom(MoveBoard(board, *result.move).board, gen)
+                                : SpawnRandom(SpawnRandom(0, gen), gen);
+        }
+
+        return options.searches;
+    });
+
+    return 0;
+}
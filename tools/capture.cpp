@@ -0,0 +1,244 @@
+#include "../src/frame_capture.h"
+#include "../src/frame_writer.h"
+#include "../src/game_record.h"
+#include "../src/game_renderer.h"
+#include "../src/layout.h"
+#include "../src/mapped_file.h"
+#include "../src/resources.h"
+#include "../src/search.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_capture <directory> [--record <file> [--game <n>]] [--moves <n>] [--seed <n>]\n"
+                 "                    [--depth <n>] [--width <px>] [--height <px>] [--threads <n>]\n"
+                 "renders a game of a record file (2048_train --record), or one played by the AI, into PNG frames\n"
+                 "with the software renderer: no window or display is needed\n";
+}
+
+struct CaptureOptions
+{
+    std::filesystem::path directory;
+    std::filesystem::path record_path;
+    size_t game = 0;
+    size_t moves = 2000;
+    std::uint32_t seed = 1;
+    int depth = 2;
+    int width = ApplicationLayout::DESIGN_WIDTH;
+    int height = ApplicationLayout::DESIGN_HEIGHT;
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1U);
+};
+
+struct CaptureStep
+{
+    Board board = 0;
+    std::uint64_t score = 0;
+};
+
+auto RecordSteps(const CaptureOptions &options) -> std::vector<CaptureStep>
+{
+    const MappedFile file(options.record_path);
+    GameRecordReader reader(file.Bytes());
+    GameRecordView record;
+
+    for (size_t game = 0; game <= options.game; ++game)
+    {
+        if (!reader.Next(record))
+        {
+            throw std::runtime_error(std::format("{} has no game {}", options.record_path.string(), options.game));
+        }
+    }
+
+    std::vector<CaptureStep> steps = {{record.start, 0}};
+
+    for (const auto step : record.steps.first(std::min(options.moves, record.steps.size())))
+    {
+        const auto next = ApplyStep(steps.back().board, step);
+
+        if (!next)
+        {
+            throw std::runtime_error(std::format("game {} has an invalid move", options.game));
+        }
+
+        steps.push_back({next->board, steps.back().score + next->score});
+    }
+
+    return steps;
+}
+
+auto PlayedSteps(const CaptureOptions &options) -> std::vector<CaptureStep>
+{
+    std::mt19937 gen(options.seed);
+    SearchOptions search_options;
+    search_options.depth = options.depth;
+    Expectimax search(search_options);
+
+    std::vector<CaptureStep> steps = {{SpawnRandom(SpawnRandom(0, gen), gen), 0}};
+
+    while (steps.size() <= options.moves)
+    {
+        const auto move = search.BestMove(steps.back().board).move;
+
+        if (!move)
+        {
+            break;
+        }
+
+        const auto [after, score] = MoveBoard(steps.back().board, *move);
+        steps.push_back({SpawnRandom(after, gen), steps.back().score + score});
+    }
+
+    return steps;
+}
+
+void Render(const CaptureOptions &options, const std::vector<CaptureStep> &steps)
+{
+    if (!TTF_Init())
+    {
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    // a software renderer drawing into memory, which needs no video driver
+    SDL_Surface *canvas = SDL_CreateSurface(options.width, options.height, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer *renderer = canvas ? SDL_CreateSoftwareRenderer(canvas) : nullptr;
+
+    if (!renderer)
+    {
+        throw std::runtime_error(SDL_GetError());
+    }
+
+    TTF_Font *font = OpenEmbeddedFont(50);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    {
+        GameRenderer game_renderer(renderer, font);
+        // a couple of frames per encoder, enough to keep every worker busy
+        FrameWriter writer(options.directory, options.threads, 2 * static_cast<size_t>(options.threads));
+        FrameCapture capture(renderer, options.width, options.height, writer);
+        const ApplicationLayout layout(options.width, options.height);
+        Grid grid;
+
+        for (const auto &[board, score] : steps)
+        {
+            UnpackGrid(board, grid);
+
+            capture.BeginFrame();
+            SDL_RenderClear(renderer);
+            game_renderer.DrawBackground(layout.grid_layout.bg_color);
+            game_renderer.DrawScoreBoard(score, steps.back().score, layout.score_board_layout);
+            game_renderer.DrawGrid(grid, layout.grid_layout);
+            capture.EndFrame();
+            game_renderer.EndFrame();
+        }
+
+        capture.Flush();
+        writer.Finish();
+    }
+
+    TTF_CloseFont(font);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(canvas);
+    TTF_Quit();
+    SDL_Quit();
+}
+
+auto main(int argc, char **argv) -> int
+{
+    CaptureOptions options;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view option = argv[i];
+
+            if (!option.starts_with("--"))
+            {
+                options.directory = option;
+                continue;
+            }
+
+            if (i + 1 == argc)
+            {
+                PrintUsage();
+                return 1;
+            }
+
+            const std::string value = argv[++i];
+
+            if (option == "--record")
+            {
+                options.record_path = value;
+            }
+            else if (option == "--game")
+            {
+                options.game = std::stoull(value);
+            }
+            else if (option == "--moves")
+            {
+                options.moves = std::stoull(value);
+            }
+            else if (option == "--seed")
+            {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--depth")
+            {
+                options.depth = std::stoi(value);
+            }
+            else if (option == "--width")
+            {
+                options.width = std::stoi(value);
+            }
+            else if (option == "--height")
+            {
+                options.height = std::stoi(value);
+            }
+            else if (option == "--threads")
+            {
+                options.threads = std::max(static_cast<unsigned>(std::stoul(value)), 1U);
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+
+        if (options.directory.empty() || options.width <= 0 || options.height <= 0)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const auto steps = options.record_path.empty() ? PlayedSteps(options) : RecordSteps(options);
+        const auto start = std::chrono::steady_clock::now();
+        Render(options, steps);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::format("{} frames of {}x{} in {:.2f}s ({:.1f} frames/s) to {}\n", steps.size(),
+                                 options.width, options.height, elapsed,
+                                 static_cast<double>(steps.size()) / std::max(elapsed, 1e-9),
+                                 options.directory.string());
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
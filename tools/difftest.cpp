@@ -0,0 +1,76 @@
+#include "../src/differential.h"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_difftest [--cases <n>] [--seed <n>] [--engine <name>]\n"
+                 "checks the move engines against the rules of Game on random boards and move sequences\n";
+}
+
+auto main(int argc, char **argv) -> int
+{
+    std::uint64_t cases = 1000000;
+    std::uint32_t seed = 1;
+    std::string engine_name;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view option = argv[i];
+
+            if (option == "--cases" && i + 1 < argc)
+            {
+                cases = std::stoull(argv[++i]);
+            }
+            else if (option == "--seed" && i + 1 < argc)
+            {
+                seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (option == "--engine" && i + 1 < argc)
+            {
+                engine_name = argv[++i];
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    bool diverged = false;
+
+    for (const auto &engine : MoveEngines())
+    {
+        if (!engine_name.empty() && engine.name != engine_name)
+        {
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto report = RunDifferential(engine, cases, seed);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::format("{:<16}{:>12} cases{:>14} moves{:>12.0f} moves/s\n", engine.name, report.cases,
+                                 report.moves, static_cast<double>(report.moves) / std::max(elapsed, 1e-9));
+
+        if (report.counterexample)
+        {
+            std::cout << FormatCounterexample(*report.counterexample);
+            diverged = true;
+        }
+    }
+
+    return diverged ? 2 : 0;
+}
@@ -0,0 +1,81 @@
+#include "../src/protocol.h"
+#include "../src/shared_state.h"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_engine [--seed <n>] [--publish <name>]\n"
+                 "reads one command per line on stdin and answers one line per command on stdout,\n"
+                 "commands: new [seed], position <board> [score], state, legal, move <u|d|l|r>, spawn,\n"
+                 "          play <letters>, hash, quit\n"
+                 "--publish shares the game after every command with 2048_viewer, through shared memory\n";
+}
+
+auto main(int argc, char **argv) -> int
+{
+    std::uint32_t seed = std::random_device()();
+    std::unique_ptr<StatePublisher> publisher;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view option = argv[i];
+
+            if (option == "--seed" && i + 1 < argc)
+            {
+                seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (option == "--publish" && i + 1 < argc)
+            {
+                publisher = std::make_unique<StatePublisher>(argv[++i]);
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    EngineProtocol protocol(seed);
+    std::string line;
+
+    while (std::getline(std::cin, line) && line != "quit")
+    {
+        try
+        {
+            std::cout << protocol.Execute(line) << '\n';
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "error " << e.what() << '\n';
+        }
+
+        if (publisher)
+        {
+            publisher->Publish(TakeSnapshot(protocol.GetGame()));
+        }
+
+        // a client that pipelines commands gets all the answers in one write
+        if (std::cin.rdbuf()->in_avail() <= 0)
+        {
+            std::cout.flush();
+        }
+    }
+
+    return 0;
+}
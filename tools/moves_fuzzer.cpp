@@ -0,0 +1,40 @@
+#include "../src/differential.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// libFuzzer entry point: the first 8 bytes are the start board, every following byte is a step, the direction in
+// bits 0-1 and the spawn cell in bits 2-5. Divergences are minimized and abort, so that libFuzzer keeps the input.
+extern "C" auto LLVMFuzzerTestOneInput(const std::uint8_t *data, const size_t size) -> int
+{
+    DifferentialCase test_case;
+
+    if (size < sizeof(Board))
+    {
+        return 0;
+    }
+
+    std::memcpy(&test_case.start, data, sizeof(Board));
+
+    for (size_t i = sizeof(Board); i < size; ++i)
+    {
+        const auto dir = static_cast<Direction>(data[i] & 0x3);
+        test_case.steps.push_back({dir, static_cast<std::uint8_t>((data[i] >> 2) & 0xf)});
+    }
+
+    for (const auto &engine : MoveEngines())
+    {
+        std::uint64_t checked = 0;
+
+        if (const auto counterexample = CheckCase(engine, test_case, checked))
+        {
+            std::cerr << FormatCounterexample(MinimizeCounterexample(engine, *counterexample));
+            std::abort();
+        }
+    }
+
+    return 0;
+}
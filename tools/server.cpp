@@ -0,0 +1,87 @@
+#include "../src/server.h"
+
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_server [--socket <path> | --port <n>] [--reactors <n>]\n"
+                 "hosts games for local clients, see src/server.h for the message format\n";
+}
+
+auto main(int argc, char **argv) -> int
+{
+    if (argc % 2 != 1)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    ServerOptions options;
+    options.port = 2048;
+    options.reactors = std::max(std::thread::hardware_concurrency(), 1U);
+
+    try
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string_view option = argv[i];
+            const std::string value = argv[i + 1];
+
+            if (option == "--socket")
+            {
+                options.socket_path = value;
+            }
+            else if (option == "--port")
+            {
+                options.port = static_cast<std::uint16_t>(std::stoul(value));
+            }
+            else if (option == "--reactors")
+            {
+                options.reactors = static_cast<unsigned>(std::stoul(value));
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+
+        // the reactor threads inherit the mask, so that only sigwait sees the signals
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        Server server(options);
+
+        if (options.socket_path.empty())
+        {
+            std::cout << "listening on 127.0.0.1:" << server.Port();
+        }
+        else
+        {
+            std::cout << "listening on " << options.socket_path.string();
+        }
+
+        std::cout << " with " << options.reactors << " reactors" << std::endl;
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+
+        std::cout << "stopping, " << server.Sessions() << " sessions still open" << std::endl;
+        server.Stop();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "../src/game_stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_stats <directory|file>... [--threads <n>]\n"
+                 "replays the game records (*.rec) found in the directories, e.g. those of 2048_train --record\n";
+}
+
+template <typename T> void PrintDistribution(const std::string_view name, const std::vector<T> &values)
+{
+    std::cout << std::format("{:<8}", name);
+
+    for (const double percent : {1.0, 10.0, 50.0, 90.0, 99.0, 100.0})
+    {
+        std::cout << std::format("  p{:<3}{:>10}", percent, Percentile(values, percent));
+    }
+
+    std::cout << '\n';
+}
+
+void PrintStats(const GameStats &stats)
+{
+    PrintDistribution("score", stats.scores);
+    PrintDistribution("length", stats.lengths);
+
+    std::cout << "reached";
+
+    for (std::uint8_t exponent = 9; exponent <= MAX_EXPONENT; ++exponent)
+    {
+        if (stats.ReachRate(exponent) > 0)
+        {
+            std::cout << std::format("  {} {:.2f}%", ExponentToValue(exponent), stats.ReachRate(exponent) * 100);
+        }
+    }
+
+    std::cout << "\nmoves  ";
+
+    for (const auto dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT})
+    {
+        const auto count = stats.directions.at(static_cast<size_t>(dir));
+        const auto share = stats.moves == 0 ? 0.0 : static_cast<double>(count) / static_cast<double>(stats.moves);
+        std::cout << std::format("  {} {:.2f}%", DirectionName(dir), share * 100);
+    }
+
+    std::cout << '\n';
+}
+
+auto main(int argc, char **argv) -> int
+{
+    std::vector<std::filesystem::path> inputs;
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view argument = argv[i];
+
+            if (argument == "--threads" && i + 1 < argc)
+            {
+                threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+            else if (argument.starts_with("--"))
+            {
+                PrintUsage();
+                return 1;
+            }
+            else
+            {
+                inputs.emplace_back(argument);
+            }
+        }
+
+        if (inputs.empty())
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const auto files = FindRecordFiles(inputs);
+        const auto start = std::chrono::steady_clock::now();
+        const auto stats = CollectGameStats(files, threads);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::format("{} files  {} games  {} moves  {} invalid  {:.2f}s  {:.1f}M moves/s\n", files.size(),
+                                 stats.games, stats.moves, stats.invalid, elapsed,
+                                 static_cast<double>(stats.moves) / std::max(elapsed, 1e-9) / 1e6);
+        PrintStats(stats);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
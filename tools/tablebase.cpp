@@ -0,0 +1,107 @@
+#include "../src/tablebase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+void PrintUsage()
+{
+    std::cerr << "usage:\n"
+                 "  2048_tablebase generate <output> --fixed <board> --free <mask> --max <exponent> [--threads <n>]\n"
+                 "  2048_tablebase probe <table> <board>\n"
+                 "boards and masks are hexadecimal, one nibble per cell, cell (0, 0) last\n"
+                 "a table has (max + 1) ^ (free cells) positions, at most 2^31. Generating one needs 4 bytes\n"
+                 "of memory per position, 8 GiB at the limit, plus 4 per position of its largest tile sum;\n"
+                 "the file takes 2 bytes per position\n";
+}
+
+auto Generate(const int argc, char **argv) -> int
+{
+    TablebaseSpec spec;
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        const std::string_view option = argv[i];
+        const std::string value = argv[i + 1];
+
+        if (option == "--fixed")
+        {
+            spec.fixed = std::stoull(value, nullptr, 16);
+        }
+        else if (option == "--free")
+        {
+            spec.free_mask = static_cast<std::uint16_t>(std::stoul(value, nullptr, 16));
+        }
+        else if (option == "--max")
+        {
+            spec.max_exponent = static_cast<std::uint8_t>(std::stoul(value));
+        }
+        else if (option == "--threads")
+        {
+            threads = static_cast<unsigned>(std::stoul(value));
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    GenerateTablebase(spec, argv[2], threads);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "generated " << TablebaseIndex(spec).Size() << " positions in " << elapsed.count() << "s\n";
+    return 0;
+}
+
+auto Probe(char **argv) -> int
+{
+    const Tablebase tablebase(argv[2]);
+    const Board board = std::stoull(argv[3], nullptr, 16);
+
+    if (const auto probability = tablebase.Probe(board))
+    {
+        std::cout << *probability << '\n';
+        return 0;
+    }
+
+    std::cout << "position is not covered by the tablebase\n";
+    return 2;
+}
+
+auto main(int argc, char **argv) -> int
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const std::string_view command = argv[1];
+
+    try
+    {
+        if (command == "generate")
+        {
+            return Generate(argc, argv);
+        }
+
+        if (command == "probe" && argc == 4)
+        {
+            return Probe(argv);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    PrintUsage();
+    return 1;
+}
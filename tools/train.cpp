@@ -0,0 +1,90 @@
+#include "../src/td_trainer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_train <network> [--games <n>] [--threads <n>] [--learning-rate <alpha>] [--seed <n>]\n"
+                 "                  [--checkpoint-every <games>] [--report-every <games>] [--record <file>]\n"
+                 "training resumes from <network> when it exists, checkpoints are written to the same file\n";
+}
+
+auto main(int argc, char **argv) -> int
+{
+    if (argc < 2 || argc % 2 != 0)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    TrainOptions options;
+    options.threads = std::max(std::thread::hardware_concurrency(), 1U);
+    options.checkpoint_path = argv[1];
+    options.checkpoint_every = 10000;
+
+    try
+    {
+        for (int i = 2; i + 1 < argc; i += 2)
+        {
+            const std::string_view option = argv[i];
+            const std::string value = argv[i + 1];
+
+            if (option == "--games")
+            {
+                options.games = std::stoull(value);
+            }
+            else if (option == "--threads")
+            {
+                options.threads = static_cast<unsigned>(std::stoul(value));
+            }
+            else if (option == "--learning-rate")
+            {
+                options.learning_rate = std::stof(value);
+            }
+            else if (option == "--seed")
+            {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--checkpoint-every")
+            {
+                options.checkpoint_every = std::stoull(value);
+            }
+            else if (option == "--report-every")
+            {
+                options.report_every = std::stoull(value);
+            }
+            else if (option == "--record")
+            {
+                options.record_path = value;
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+
+        auto network = std::filesystem::exists(options.checkpoint_path)
+                           ? NTupleNetwork::Load(options.checkpoint_path)
+                           : NTupleNetwork::Standard();
+
+        TrainNetwork(network, options, [](const TrainProgress &progress) {
+            std::cout << "games " << progress.games << "  mean score " << progress.mean_score << "  win rate "
+                      << progress.win_rate * 100 << "%  max tile " << ExponentToValue(progress.max_exponent)
+                      << std::endl;
+        });
+
+        network.Save(options.checkpoint_path);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "../src/board.h"
+#include "../src/protocol.h"
+#include "../src/shared_state.h"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+void PrintUsage()
+{
+    std::cerr << "usage: 2048_viewer <name> [--poll-ms <n>] [--once]\n"
+                 "prints the game that `2048 --publish <name>` or `2048_engine --publish <name>` publishes,\n"
+                 "every time it changes; --once prints it once and exits\n";
+}
+
+void PrintSnapshot(const GameSnapshot &snapshot)
+{
+    std::cout << std::format("move {}  score {}  best {}  {}\n", snapshot.moves, snapshot.score, snapshot.best_score,
+                             GameStateName(snapshot.state));
+
+    for (size_t row = 0; row < BOARD_SIZE; ++row)
+    {
+        for (size_t col = 0; col < BOARD_SIZE; ++col)
+        {
+            const auto value = snapshot.tiles.at(row * BOARD_SIZE + col);
+            std::cout << (value == 0 ? std::format("{:>7}", '.') : std::format("{:>7}", value));
+        }
+
+        std::cout << '\n';
+    }
+
+    std::cout << std::endl;
+}
+
+auto main(int argc, char **argv) -> int
+{
+    std::string name;
+    auto poll = std::chrono::milliseconds(10);
+    bool once = false;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view argument = argv[i];
+
+            if (argument == "--poll-ms" && i + 1 < argc)
+            {
+                poll = std::chrono::milliseconds(std::stoul(argv[++i]));
+            }
+            else if (argument == "--once")
+            {
+                once = true;
+            }
+            else if (argument.starts_with("--") || !name.empty())
+            {
+                PrintUsage();
+                return 1;
+            }
+            else
+            {
+                name = argument;
+            }
+        }
+
+        if (name.empty())
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        std::optional<StateViewer> viewer;
+
+        // the game may not have started yet
+        while (!viewer)
+        {
+            try
+            {
+                viewer.emplace(name);
+            }
+            catch (const std::runtime_error &)
+            {
+                if (once)
+                {
+                    throw;
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+        }
+
+        std::uint64_t seen = 0;
+
+        while (true)
+        {
+            // polling is a single load from the shared page, the game never notices it
+            const auto sequence = viewer->Sequence();
+
+            if (sequence != seen || once)
+            {
+                if (const auto snapshot = viewer->Read())
+                {
+                    seen = sequence;
+                    PrintSnapshot(*snapshot);
+                }
+
+                if (once)
+                {
+                    break;
+                }
+            }
+
+            std::this_thread::sleep_for(poll);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}